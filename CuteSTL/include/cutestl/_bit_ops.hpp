@@ -0,0 +1,92 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+// Bitset / DynamicBitset / RankSelect 共用: 按 64 位字操作的位运算
+// NOTE: std::popcount / std::countr_zero 在开启 -mpopcnt -mbmi (或 -march=native) 时
+// 编译为单条 popcnt / tzcnt 指令, 否则退化为查表或位运算, 结果相同
+
+namespace cutestl {
+
+inline constexpr std::size_t _kWordBits = 64;
+
+constexpr std::size_t _WordCount(std::size_t bits) noexcept {
+    return (bits + _kWordBits - 1) / _kWordBits;
+}
+
+// 最后一个字中有效位的掩码; bits 是 64 的倍数时为全 1
+constexpr std::uint64_t _TailMask(std::size_t bits) noexcept {
+    std::size_t rem = bits % _kWordBits;
+    return rem ? (std::uint64_t{1} << rem) - 1 : ~std::uint64_t{0};
+}
+
+// 批量计数: 4 路独立累加, 打断相邻 popcnt 之间的依赖链
+inline std::size_t _PopcountWords(std::uint64_t const* words, std::size_t n) noexcept {
+    std::size_t c0 = 0;
+    std::size_t c1 = 0;
+    std::size_t c2 = 0;
+    std::size_t c3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += std::popcount(words[i]);
+        c1 += std::popcount(words[i + 1]);
+        c2 += std::popcount(words[i + 2]);
+        c3 += std::popcount(words[i + 3]);
+    }
+    for (; i < n; ++i) {
+        c0 += std::popcount(words[i]);
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+// 从第 pos 位起 (含) 第一个为 1 的位; 没有时返回 n_words * 64
+inline std::size_t _FindSetBit(std::uint64_t const* words, std::size_t n_words,
+                               std::size_t pos) noexcept {
+    std::size_t index = pos / _kWordBits;
+    if (index >= n_words) {
+        return n_words * _kWordBits;
+    }
+    // 第一个字去掉 pos 之前的位, 之后整字跳过全 0 的字
+    std::uint64_t word = words[index] & (~std::uint64_t{0} << (pos % _kWordBits));
+    while (word == 0) {
+        if (++index == n_words) {
+            return n_words * _kWordBits;
+        }
+        word = words[index];
+    }
+    return index * _kWordBits + std::countr_zero(word);
+}
+
+// 字内第 k 个 (从 0 数) 为 1 的位的下标; 调用方保证 k < popcount(word)
+inline unsigned _SelectInWord(std::uint64_t word, unsigned k) noexcept {
+#if defined(__BMI2__)
+    // pdep 把 1 << k 存放到 word 的第 k 个 1 的位置上
+    return static_cast<unsigned>(std::countr_zero(_pdep_u64(std::uint64_t{1} << k, word)));
+#else
+    // 按 32 / 16 / 8 位二分缩小范围, 最后在一个字节里逐个清掉低位的 1
+    unsigned pos = 0;
+    for (unsigned width = 32; width >= 8; width /= 2) {
+        std::uint64_t low = word & ((std::uint64_t{1} << width) - 1);
+        auto count = static_cast<unsigned>(std::popcount(low));
+        if (k >= count) {
+            k -= count;
+            word >>= width;
+            pos += width;
+        } else {
+            word = low;
+        }
+    }
+    for (; k > 0; --k) {
+        word &= word - 1;
+    }
+    return pos + static_cast<unsigned>(std::countr_zero(word));
+#endif
+}
+
+}  // namespace cutestl
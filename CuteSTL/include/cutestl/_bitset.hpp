@@ -0,0 +1,179 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "_bit_ops.hpp"
+
+// 定长位集, 按 64 位字存储
+// 用法:
+//   Bitset<1024> mask;
+//   mask.Set(3);
+//   for (auto i = mask.FindFirst(); i < mask.Size(); i = mask.FindNext(i)) { ... }
+//   mask.ForEachSetBit([](std::size_t i) { ... });  // 同上, 更快
+//
+// NOTE: 与 std::bitset 的区别
+// - 查找: FindFirst / FindNext 整字跳过全 0 的字, 找不到时返回 Size()
+// - 没有按位引用的代理类型, 读用 Test / operator[], 写用 Set / Reset / Flip
+// NOTE: 不变式: 最后一个字中超出 N 的位始终为 0, Count / == / Flip 依赖它
+
+namespace cutestl {
+
+template <std::size_t N>
+class Bitset {
+public:
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+    static constexpr size_type kWords = _WordCount(N);
+
+public:
+    constexpr Bitset() noexcept = default;
+
+    // 用一个字初始化低 64 位
+    constexpr explicit Bitset(word_type value) noexcept {
+        if constexpr (kWords > 0) {
+            words_[0] = value;
+            ClearTail();
+        }
+    }
+
+public:
+    static constexpr size_type Size() noexcept { return N; }
+
+    constexpr bool Test(size_type pos) const noexcept {
+        assert(pos < N);
+        return (words_[pos / _kWordBits] >> (pos % _kWordBits)) & 1;
+    }
+
+    constexpr bool operator[](size_type pos) const noexcept { return Test(pos); }
+
+    constexpr Bitset& Set(size_type pos, bool value = true) noexcept {
+        assert(pos < N);
+        word_type bit = word_type{1} << (pos % _kWordBits);
+        word_type& word = words_[pos / _kWordBits];
+        word = value ? word | bit : word & ~bit;
+        return *this;
+    }
+
+    constexpr Bitset& Set() noexcept {
+        words_.fill(~word_type{0});
+        ClearTail();
+        return *this;
+    }
+
+    constexpr Bitset& Reset(size_type pos) noexcept { return Set(pos, false); }
+
+    constexpr Bitset& Reset() noexcept {
+        words_.fill(0);
+        return *this;
+    }
+
+    constexpr Bitset& Flip(size_type pos) noexcept {
+        assert(pos < N);
+        words_[pos / _kWordBits] ^= word_type{1} << (pos % _kWordBits);
+        return *this;
+    }
+
+    constexpr Bitset& Flip() noexcept {
+        for (word_type& word : words_) {
+            word = ~word;
+        }
+        ClearTail();
+        return *this;
+    }
+
+public:
+    size_type Count() const noexcept { return _PopcountWords(words_.data(), kWords); }
+
+    constexpr bool Any() const noexcept {
+        for (word_type word : words_) {
+            if (word) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr bool None() const noexcept { return !Any(); }
+
+    bool All() const noexcept { return Count() == N; }
+
+    // 第一个为 1 的位; 没有时返回 Size()
+    size_type FindFirst() const noexcept { return Find(0); }
+
+    // prev 之后第一个为 1 的位; 没有时返回 Size()
+    size_type FindNext(size_type prev) const noexcept { return Find(prev + 1); }
+
+    // 按升序对每个为 1 的位调用 f(pos), 每个 1 只需一次 tzcnt 与一次清最低位
+    template <typename F>
+    void ForEachSetBit(F&& f) const {
+        for (size_type i = 0; i < kWords; ++i) {
+            for (word_type word = words_[i]; word; word &= word - 1) {
+                f(i * _kWordBits + std::countr_zero(word));
+            }
+        }
+    }
+
+    // 底层字数组, 低位在前; 可以交给 RankSelect
+    std::span<word_type const> Words() const noexcept { return {words_.data(), kWords}; }
+
+public:
+    constexpr Bitset& operator&=(Bitset const& other) noexcept {
+        for (size_type i = 0; i < kWords; ++i) {
+            words_[i] &= other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr Bitset& operator|=(Bitset const& other) noexcept {
+        for (size_type i = 0; i < kWords; ++i) {
+            words_[i] |= other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr Bitset& operator^=(Bitset const& other) noexcept {
+        for (size_type i = 0; i < kWords; ++i) {
+            words_[i] ^= other.words_[i];
+        }
+        return *this;
+    }
+
+    // *this &= ~other, 不需要临时对象
+    constexpr Bitset& AndNot(Bitset const& other) noexcept {
+        for (size_type i = 0; i < kWords; ++i) {
+            words_[i] &= ~other.words_[i];
+        }
+        return *this;
+    }
+
+    constexpr Bitset operator~() const noexcept { return Bitset{*this}.Flip(); }
+
+    friend constexpr Bitset operator&(Bitset lhs, Bitset const& rhs) noexcept { return lhs &= rhs; }
+
+    friend constexpr Bitset operator|(Bitset lhs, Bitset const& rhs) noexcept { return lhs |= rhs; }
+
+    friend constexpr Bitset operator^(Bitset lhs, Bitset const& rhs) noexcept { return lhs ^= rhs; }
+
+    friend constexpr bool operator==(Bitset const&, Bitset const&) noexcept = default;
+
+private:
+    size_type Find(size_type pos) const noexcept {
+        size_type found = _FindSetBit(words_.data(), kWords, pos);
+        return found < N ? found : N;
+    }
+
+    constexpr void ClearTail() noexcept {
+        if constexpr (kWords > 0) {
+            words_[kWords - 1] &= _TailMask(N);
+        }
+    }
+
+    std::array<word_type, kWords> words_{};
+};
+
+}  // namespace cutestl
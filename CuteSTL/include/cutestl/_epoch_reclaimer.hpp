@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+#include "_hardware.hpp"
+#include "_reclaim_common.hpp"
+
+// 基于纪元的内存回收 (Epoch-Based Reclamation, EBR)
+// 用法:
+//   {
+//       EpochGuard guard;                 // 进入临界区, 期间读到的节点不会被释放
+//       Node* node = head.load(std::memory_order_acquire);
+//       ...
+//   }
+//   // 摘除节点后:
+//   Retire(node);                         // 等所有可能看到它的线程离开临界区后再 delete
+//
+// NOTE: 原理
+// - 全局纪元 global_ 单调递增; 线程进入临界区时把当时的纪元登记到自己的记录上
+// - 只有所有处于临界区的线程都已登记当前纪元 e 时, 全局纪元才能推进到 e + 1
+// - 在纪元 e 退休的指针, 等全局纪元到达 e + 2 时, 纪元 e 时的读者必然都已离开, 可以释放
+// - 读路径只有一次线程局部查找 + 一次 store + 一次 fence, 没有逐节点的原子计数
+
+namespace cutestl {
+
+// 每个线程在域上的记录, 按缓存行对齐避免登记纪元时伪共享
+struct alignas(kCacheLineSize) _EpochRecord {
+    std::atomic<std::uint64_t> epoch_{std::numeric_limits<std::uint64_t>::max()};  // 登记的纪元
+    std::atomic<bool> in_use_{false};
+    _EpochRecord* next_{nullptr};
+    std::uint32_t nesting_{0};        // 临界区嵌套层数
+    std::uint32_t since_collect_{0};  // 上次回收后退休的个数
+    _RetiredList retired_;
+};
+
+class EpochGuard;
+
+class EpochDomain {
+    friend class EpochGuard;
+    friend class _ThreadRecordCache<EpochDomain, _EpochRecord>;
+
+public:
+    EpochDomain() = default;
+    EpochDomain(EpochDomain const&) = delete;
+    EpochDomain& operator=(EpochDomain const&) = delete;
+
+    // NOTE: 析构时不能有线程处于临界区 (用过它的线程可以还活着); 剩余的退休指针全部释放
+    ~EpochDomain() {
+        _ThreadRecordCache<EpochDomain, Record>::Detach(this);
+        records_.ForEach([](Record& record) { record.retired_.ReclaimAll(); });
+        orphans_.ReclaimAll();
+    }
+
+    // 进程级默认域, 有意不析构 (线程退出顺序不确定)
+    static EpochDomain& Global() {
+        static EpochDomain* domain = new EpochDomain;
+        return *domain;
+    }
+
+    // 退休 ptr: 之后不再有新的读者能看到它, 已有的读者离开临界区后由 Deleter 释放
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void Retire(T* ptr, Deleter = {}) {
+        if (!ptr) {
+            return;
+        }
+        Record* record = Local();
+        // NOTE: 保证读取纪元发生在调用方摘除节点 (之前的原子写) 之后
+        _SeqCstFence();
+        std::uint64_t epoch = global_.load(std::memory_order_relaxed);
+        record->retired_.Push(_Retired{ptr, &_RetiredDelete<T, Deleter>}, epoch);
+        if (++record->since_collect_ >= kCollectInterval) {
+            Collect(record);
+        }
+    }
+
+    // 尝试推进纪元并回收本线程 (及已退出线程) 中可以释放的指针, 返回回收个数
+    std::size_t Collect() { return Collect(Local()); }
+
+    // 当前线程待回收的指针个数
+    std::size_t Pending() { return Local()->retired_.Size(); }
+
+private:
+    using Record = _EpochRecord;
+
+    static constexpr std::uint64_t kInactive = std::numeric_limits<std::uint64_t>::max();
+    static constexpr std::uint32_t kCollectInterval = 64;  // 每退休这么多个指针尝试回收一次
+
+    Record* Local() { return _ThreadRecordCache<EpochDomain, Record>::Get(this); }
+
+    Record* AcquireThreadRecord() { return records_.Acquire(); }
+
+    // 线程退出: 未回收的指针交给域, 由其他线程日后回收
+    void ReleaseThreadRecord(Record* record);
+
+    void Enter(Record* record) noexcept;
+    void Leave(Record* record) noexcept;
+
+    // 所有处于临界区的线程都已登记当前纪元时推进纪元
+    void TryAdvance() noexcept;
+
+    std::size_t Collect(Record* record);
+
+    alignas(kCacheLineSize) std::atomic<std::uint64_t> global_{0};
+    alignas(kCacheLineSize) _RecordList<Record> records_;
+    std::mutex orphans_mtx_;
+    std::atomic<bool> has_orphans_{false};
+    _RetiredList orphans_;  // 已退出线程留下的退休指针
+    std::shared_ptr<_DomainLife> life_{std::make_shared<_DomainLife>()};  // 见 _ThreadRecordCache
+};
+
+inline void EpochDomain::Enter(Record* record) noexcept {
+    if (record->nesting_++ == 0) {
+        record->epoch_.store(global_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        // HACK: store-load 屏障, 保证登记先于临界区内对共享指针的读取对其他线程可见
+        _SeqCstFence();
+    }
+}
+
+inline void EpochDomain::Leave(Record* record) noexcept {
+    if (--record->nesting_ == 0) {
+        record->epoch_.store(kInactive, std::memory_order_release);
+    }
+}
+
+inline void EpochDomain::TryAdvance() noexcept {
+    _SeqCstFence();
+    std::uint64_t epoch = global_.load(std::memory_order_relaxed);
+    bool all_caught_up = true;
+    records_.ForEach([&](Record& record) {
+        std::uint64_t seen = record.epoch_.load(std::memory_order_acquire);
+        if (seen != kInactive && seen != epoch) {
+            all_caught_up = false;
+        }
+    });
+    if (all_caught_up) {
+        global_.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel,
+                                        std::memory_order_relaxed);
+    }
+}
+
+inline std::size_t EpochDomain::Collect(Record* record) {
+    record->since_collect_ = 0;
+    TryAdvance();
+    std::uint64_t epoch = global_.load(std::memory_order_acquire);
+    if (epoch < 2) {
+        return 0;
+    }
+    std::size_t reclaimed = record->retired_.ReclaimUpTo(epoch - 2);
+    if (has_orphans_.load(std::memory_order_relaxed)) {
+        std::lock_guard lk{orphans_mtx_};
+        reclaimed += orphans_.ReclaimUpTo(epoch - 2);
+        has_orphans_.store(!orphans_.Empty(), std::memory_order_relaxed);
+    }
+    return reclaimed;
+}
+
+inline void EpochDomain::ReleaseThreadRecord(Record* record) {
+    Collect(record);
+    if (!record->retired_.Empty()) {
+        std::lock_guard lk{orphans_mtx_};
+        orphans_.Splice(record->retired_);
+        has_orphans_.store(true, std::memory_order_relaxed);
+    }
+    record->since_collect_ = 0;
+    _RecordList<Record>::Release(record);
+}
+
+// RAII 临界区, 可以嵌套
+class EpochGuard {
+public:
+    explicit EpochGuard(EpochDomain& domain = EpochDomain::Global())
+        : domain_(&domain), record_(domain.Local()) {
+        domain_->Enter(record_);
+    }
+
+    EpochGuard(EpochGuard const&) = delete;
+    EpochGuard& operator=(EpochGuard const&) = delete;
+
+    ~EpochGuard() { domain_->Leave(record_); }
+
+private:
+    EpochDomain* domain_;
+    _EpochRecord* record_;
+};
+
+// 在默认域上退休
+template <typename T, typename Deleter = std::default_delete<T>>
+void Retire(T* ptr, Deleter deleter = {}) {
+    EpochDomain::Global().Retire(ptr, deleter);
+}
+
+}  // namespace cutestl
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+
+// FlatMap / FlatSet 共用: 有序数组上的无分支二分查找, 以及 "已排序且无重复" 标签
+//
+// NOTE: 普通二分每步一个取决于数据的分支, 随机查找时约一半预测失败;
+// 这里每步只比较一次并用条件移动 (cmov) 缩小区间, 循环次数只取决于 n, 没有难以预测的分支
+
+namespace cutestl {
+
+// 构造函数的标签: 调用方保证传入的键已按比较器排序且没有重复, 跳过排序与去重
+struct sorted_unique_t {
+    explicit constexpr sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
+// 第一个不小于 key 的位置
+template <typename T, typename Q, typename Compare>
+T const* _BranchlessLowerBound(T const* first, std::size_t n, Q const& key, Compare const& comp) {
+    if (n == 0) {
+        return first;
+    }
+    // 不变式: 答案在 [first, first + n] 内
+    while (n > 1) {
+        std::size_t half = n / 2;
+        first = comp(first[half], key) ? first + half : first;
+        n -= half;
+    }
+    return first + static_cast<bool>(comp(*first, key));
+}
+
+// 第一个大于 key 的位置
+template <typename T, typename Q, typename Compare>
+T const* _BranchlessUpperBound(T const* first, std::size_t n, Q const& key, Compare const& comp) {
+    if (n == 0) {
+        return first;
+    }
+    while (n > 1) {
+        std::size_t half = n / 2;
+        first = comp(key, first[half]) ? first : first + half;
+        n -= half;
+    }
+    return first + !comp(key, *first);
+}
+
+}  // namespace cutestl
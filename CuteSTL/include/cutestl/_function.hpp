@@ -1,15 +1,18 @@
 #pragma once
 
 #include <functional>
-#include <memory>
 #include <type_traits>
-#include <typeinfo>
 #include <utility>
 
+#include "_function_storage.hpp"
+
 // 参考:
 // - https://github.com/parallel101/stl1weekend/blob/main/_Function.hpp
 // - https://github.com/parallel101/stl1weekend/blob/main/test_Function.cpp
 
+// NOTE: 小对象优化 (SBO), 见 _function_storage.hpp
+// 用手写的函数指针表 (vtable) 代替虚基类: 每种仿函数类型一份静态常量表, 调用只需一次间接跳转
+
 namespace cutestl {
 
 // 通用模板, 检测不符合 RT(Args...) 模式
@@ -22,34 +25,32 @@ class Function {
 template <typename RT, typename... Args>
 class Function<RT(Args...)> {
 private:
-    class FuncBase {
-    public:
-        virtual RT Call(Args... args) = 0;                    // 类型擦除后的统一接口
-        virtual std::unique_ptr<FuncBase> Clone() const = 0;  // 值语义, 克隆当前函数对象
-        virtual ~FuncBase() = default;
+    // 手写虚表: 类型擦除后的统一接口
+    struct VTable {
+        RT (*call_)(void* storage, Args&&... args);
+        void (*copy_)(void* dst, void const* src);     // 值语义, 在 dst 上拷贝构造
+        void (*move_)(void* dst, void* src) noexcept;  // 移动到 dst, 并销毁 src
+        void (*destroy_)(void* storage) noexcept;
     };
 
     template <typename Fn>
-    class FuncImpl : public FuncBase {
-    private:
-        Fn f_;  // 仿函数对象
-
-    public:
-        // HACK:
-        // - 直接传一个仿函数对象
-        // - 或者传 (std::in_place, args..) 就地构造 Fn f_ 对象
-        template <typename... CArgs>
-        explicit FuncImpl(std::in_place_t, CArgs&&... args) : f_(std::forward<CArgs>(args)...) {}
-
-        RT Call(Args... args) override { return std::invoke(f_, std::forward<Args>(args)...); }
-
-        std::unique_ptr<FuncBase> Clone() const override {
-            // HACK: 这里也是就地构造 f_ 作为 FuncImpl 构造函数形参
-            return std::make_unique<FuncImpl>(std::in_place, f_);
+    struct Handler {
+        using Storage = _FunctionStorage<Fn>;
+
+        // NOTE: RT 为 void 时丢弃仿函数的返回值 (与 std::function 一致)
+        static RT Call(void* storage, Args&&... args) {
+            if constexpr (std::is_void_v<RT>) {
+                std::invoke(*Storage::Get(storage), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(*Storage::Get(storage), std::forward<Args>(args)...);
+            }
         }
+
+        static constexpr VTable kVTable{&Call, &Storage::Copy, &Storage::Move, &Storage::Destroy};
     };
 
-    std::unique_ptr<FuncBase> base_;
+    VTable const* vtable_{nullptr};  // 为空表示不持有仿函数
+    mutable _FunctionBuffer storage_;
 
 public:
     Function() = default;
@@ -61,14 +62,16 @@ public:
                                    std::is_copy_constructible_v<Fn> &&
                                    !std::is_same_v<std::decay_t<Fn>, Function<RT(Args...)>>,
                                int> = 0>
-    Function(Fn&& f)
-        : base_(std::make_unique<FuncImpl<std::decay_t<Fn>>>(std::in_place, std::forward<Fn>(f))) {}
+    Function(Fn&& f) {
+        using Impl = Handler<std::decay_t<Fn>>;
+        Impl::Storage::Create(storage_.bytes_, std::forward<Fn>(f));
+        vtable_ = &Impl::kVTable;
+    }
 
     Function(Function const& other) {  // 拷贝构造
-        if (!other.base_) {
-            base_ = nullptr;
-        } else {
-            base_ = other.base_->Clone();
+        if (other.vtable_) {
+            other.vtable_->copy_(storage_.bytes_, other.storage_.bytes_);
+            vtable_ = other.vtable_;
         }
     }
 
@@ -76,26 +79,49 @@ public:
         if (this == &other) {
             return *this;
         }
-        if (!other.base_) {
-            base_ = nullptr;
-        } else {
-            base_ = other.base_->Clone();
+        Function tmp{other};  // NOTE: 先拷贝再移动, 拷贝抛异常时 *this 不变
+        return *this = std::move(tmp);
+    }
+
+    Function(Function&& other) noexcept {  // 移动构造
+        if (other.vtable_) {
+            other.vtable_->move_(storage_.bytes_, other.storage_.bytes_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
+        }
+    }
+
+    Function& operator=(Function&& other) noexcept {  // 移动赋值
+        if (this == &other) {
+            return *this;
+        }
+        Reset();
+        if (other.vtable_) {
+            other.vtable_->move_(storage_.bytes_, other.storage_.bytes_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
         }
         return *this;
     }
-    Function(Function&&) = default;             // 默认移动构造
-    Function& operator=(Function&&) = default;  // 默认移动赋值
 
-    operator bool() const noexcept { return base_ != nullptr; }
+    ~Function() { Reset(); }
+
+    operator bool() const noexcept { return vtable_ != nullptr; }
 
     // 这里不加&& 因为不是模板<->万能引用
     // 为什么这里能使用 std::forward?
     RT operator()(Args... args) const {
-        // HACK: 如果仿函数对象指针为空则报错
-        if (!base_) {
+        // HACK: 如果仿函数对象为空则报错
+        if (!vtable_) {
             throw std::bad_function_call();
         }
-        return base_->Call(std::forward<Args>(args)...);
+        return vtable_->call_(storage_.bytes_, std::forward<Args>(args)...);
+    }
+
+private:
+    void Reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy_(storage_.bytes_);
+            vtable_ = nullptr;
+        }
     }
 };
 
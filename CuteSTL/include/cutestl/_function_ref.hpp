@@ -0,0 +1,74 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// 不持有所有权的可调用对象引用: 两个指针大小, 从不分配内存, 可平凡拷贝
+// 适合作为向下传递的回调参数:
+//   void ForEach(FunctionRef<void(int)> visit);
+//   ForEach([&](int x) { sum += x; });
+// NOTE: 只引用传入的可调用对象, 调用方需保证其存活 (通常是同一个完整表达式内的临时 lambda)
+
+namespace cutestl {
+
+template <typename FnSig>
+class FunctionRef {
+    static_assert(!std::is_same_v<FnSig, FnSig>, "函数签名无效!");
+};
+
+template <typename RT, typename... Args>
+class FunctionRef<RT(Args...)> {
+private:
+    // HACK: 函数指针与对象指针不能互相转换, 用联合体分别保存
+    union Bound {
+        void* obj_;
+        void (*fn_)();
+    };
+
+    Bound bound_;
+    RT (*call_)(Bound, Args&&... args);
+
+public:
+    // 普通函数 (函数名或函数指针)
+    template <typename Fn, std::enable_if_t<std::is_function_v<Fn> &&
+                                                std::is_invocable_r_v<RT, Fn*, Args...>,
+                                            int> = 0>
+    FunctionRef(Fn* f) noexcept {
+        bound_.fn_ = reinterpret_cast<void (*)()>(f);
+        call_ = [](Bound b, Args&&... args) -> RT {
+            if constexpr (std::is_void_v<RT>) {  // 丢弃返回值
+                std::invoke(reinterpret_cast<Fn*>(b.fn_), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(reinterpret_cast<Fn*>(b.fn_), std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    // 其他可调用对象: 保存它的地址
+    template <typename Fn,
+              std::enable_if_t<!std::is_same_v<std::remove_cvref_t<Fn>, FunctionRef> &&
+                                   !std::is_pointer_v<std::remove_cvref_t<Fn>> &&
+                                   !std::is_function_v<std::remove_reference_t<Fn>> &&
+                                   std::is_invocable_r_v<RT, Fn&, Args...>,
+                               int> = 0>
+    FunctionRef(Fn&& f) noexcept {
+        using Obj = std::remove_reference_t<Fn>;
+        bound_.obj_ = const_cast<void*>(static_cast<void const volatile*>(std::addressof(f)));
+        call_ = [](Bound b, Args&&... args) -> RT {
+            if constexpr (std::is_void_v<RT>) {  // 丢弃返回值
+                std::invoke(*static_cast<Obj*>(b.obj_), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(*static_cast<Obj*>(b.obj_), std::forward<Args>(args)...);
+            }
+        };
+    }
+
+    FunctionRef(FunctionRef const&) noexcept = default;
+    FunctionRef& operator=(FunctionRef const&) noexcept = default;
+
+    RT operator()(Args... args) const { return call_(bound_, std::forward<Args>(args)...); }
+};
+
+}  // namespace cutestl
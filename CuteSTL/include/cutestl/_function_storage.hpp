@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Function / MoveOnlyFunction 共用的小对象优化 (SBO) 存储
+// - 不超过 3 个指针大小、可 noexcept 移动的仿函数直接放在内部缓冲区, 不分配堆内存
+//   (函数指针、无捕获 lambda、捕获少量引用/指针的 lambda 都属于这一类)
+// - 更大的仿函数才在堆上分配, 缓冲区里只存一个指针
+
+namespace cutestl {
+
+inline constexpr std::size_t _kFunctionInlineSize = 3 * sizeof(void*);
+inline constexpr std::size_t _kFunctionInlineAlign = alignof(std::max_align_t);
+
+// 内联缓冲区
+struct _FunctionBuffer {
+    alignas(_kFunctionInlineAlign) unsigned char bytes_[_kFunctionInlineSize];
+};
+
+// 仿函数 Fn 在缓冲区中的存取方式, 与函数签名无关
+template <typename Fn>
+struct _FunctionStorage {
+    // 放得下且移动不抛异常才内联存放, 否则移动容器时无法保证 noexcept
+    static constexpr bool kInline = sizeof(Fn) <= _kFunctionInlineSize &&
+                                    alignof(Fn) <= _kFunctionInlineAlign &&
+                                    std::is_nothrow_move_constructible_v<Fn>;
+
+    static Fn* Get(void* storage) noexcept {
+        if constexpr (kInline) {
+            return std::launder(static_cast<Fn*>(storage));
+        } else {
+            return *static_cast<Fn**>(storage);
+        }
+    }
+
+    // HACK: 就地构造 Fn 对象 (内联缓冲区或堆上)
+    template <typename... CArgs>
+    static void Create(void* storage, CArgs&&... args) {
+        if constexpr (kInline) {
+            ::new (storage) Fn(std::forward<CArgs>(args)...);
+        } else {
+            *static_cast<Fn**>(storage) = new Fn(std::forward<CArgs>(args)...);
+        }
+    }
+
+    static void Copy(void* dst, void const* src) {
+        Create(dst, std::as_const(*Get(const_cast<void*>(src))));
+    }
+
+    // 移动到 dst, 并销毁 src
+    static void Move(void* dst, void* src) noexcept {
+        if constexpr (kInline) {
+            Fn* from = Get(src);
+            ::new (dst) Fn(std::move(*from));
+            from->~Fn();
+        } else {
+            *static_cast<Fn**>(dst) = *static_cast<Fn**>(src);  // 堆上的对象只需转移指针
+        }
+    }
+
+    static void Destroy(void* storage) noexcept {
+        if constexpr (kInline) {
+            Get(storage)->~Fn();
+        } else {
+            delete Get(storage);
+        }
+    }
+};
+
+}  // namespace cutestl
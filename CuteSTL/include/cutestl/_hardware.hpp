@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+// 与硬件相关的小工具: 缓存行大小, 自旋等待提示与指数退避
+
+namespace cutestl {
+
+// NOTE: 不用 std::hardware_destructive_interference_size, 它随编译选项变化, ABI 不稳定
+inline constexpr std::size_t kCacheLineSize = 64;
+
+// 自旋等待提示: 降低自旋时的功耗, 并让出流水线给超线程兄弟
+inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// 指数退避: 前若干步执行 2^step 次 CpuRelax, 之后改为 yield, 超过 limit 步后放弃
+// 用法:
+//   Backoff backoff{limit};
+//   while (!ready()) { if (!backoff.Pause()) { 转入阻塞等待; } }
+class Backoff {
+public:
+    explicit Backoff(std::uint32_t limit) noexcept : limit_(limit) {}
+
+    // 返回 false 表示已退避到上限, 调用方应停止自旋
+    bool Pause() noexcept {
+        if (step_ >= limit_) {
+            return false;
+        }
+        if (step_ < kPauseSteps) {
+            for (std::uint32_t i = 0; i < (1u << step_); ++i) {
+                CpuRelax();
+            }
+        } else {
+            std::this_thread::yield();
+        }
+        ++step_;
+        return true;
+    }
+
+    void Reset() noexcept { step_ = 0; }
+
+private:
+    static constexpr std::uint32_t kPauseSteps = 7;  // 最多连续 64 次 pause, 之后 yield
+
+    std::uint32_t limit_;
+    std::uint32_t step_{0};
+};
+
+}  // namespace cutestl
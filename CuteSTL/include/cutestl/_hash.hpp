@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// 哈希容器的默认哈希与相等比较
+// - Hash<T> 默认转发给 std::hash<T>; 容器内部会再用 _MixHash 打散,
+//   所以 std::hash<int> 这种恒等哈希也能均匀地分布到控制字节上
+// - 字符串类型的 Hash/EqualTo 是透明的 (is_transparent): String/std::string 为键时,
+//   可以直接用 std::string_view 或字符串字面量查找, 不需要先构造一个临时键
+
+namespace cutestl {
+
+template <typename T>
+struct Hash : std::hash<T> {};
+
+template <typename T>
+struct EqualTo : std::equal_to<T> {};
+
+struct _StringHash {
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view str) const noexcept {
+        return std::hash<std::string_view>{}(str);
+    }
+};
+
+struct _StringEqual {
+    using is_transparent = void;
+
+    bool operator()(std::string_view lhs, std::string_view rhs) const noexcept {
+        return lhs == rhs;
+    }
+};
+
+template <>
+struct Hash<std::string> : _StringHash {};
+
+template <>
+struct Hash<std::string_view> : _StringHash {};
+
+template <>
+struct EqualTo<std::string> : _StringEqual {};
+
+template <>
+struct EqualTo<std::string_view> : _StringEqual {};
+
+// murmur3 的 fmix64: 每一位输入都影响每一位输出
+inline std::size_t _MixHash(std::size_t h) noexcept {
+    std::uint64_t x = h;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return static_cast<std::size_t>(x);
+}
+
+}  // namespace cutestl
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "_hardware.hpp"
+#include "_reclaim_common.hpp"
+
+// 危险指针 (Hazard Pointer)
+// 用法:
+//   HazardPointer hp;
+//   Node* node = hp.Protect(head);        // 在 hp 存活或 Reset 之前, node 不会被释放
+//   ...
+//   HazardDomain::Global().Retire(old);   // 摘除节点后退休
+//
+// 与 EpochDomain 相比: 每读一个节点多一次 store + fence, 但未回收内存有上界,
+// 一个卡住的读者只能拖住它保护的那几个节点, 而不是整个纪元之后的所有退休指针
+
+namespace cutestl {
+
+// 危险指针槽位: 由 HazardPointer 独占使用
+struct alignas(kCacheLineSize) _HazardSlot {
+    std::atomic<void*> ptr_{nullptr};
+    std::atomic<bool> in_use_{false};
+    _HazardSlot* next_{nullptr};
+};
+
+// 每个线程在域上的退休链表
+struct _HazardRetireRecord {
+    std::atomic<bool> in_use_{false};
+    _HazardRetireRecord* next_{nullptr};
+    _RetiredList retired_;
+};
+
+class HazardPointer;
+
+class HazardDomain {
+    friend class HazardPointer;
+    friend class _ThreadRecordCache<HazardDomain, _HazardRetireRecord>;
+
+public:
+    HazardDomain() = default;
+    HazardDomain(HazardDomain const&) = delete;
+    HazardDomain& operator=(HazardDomain const&) = delete;
+
+    // NOTE: 析构时不能有存活的 HazardPointer (用过它的线程可以还活着); 剩余的退休指针全部释放
+    ~HazardDomain() {
+        _ThreadRecordCache<HazardDomain, Record>::Detach(this);
+        records_.ForEach([](Record& record) { record.retired_.ReclaimAll(); });
+        orphans_.ReclaimAll();
+    }
+
+    // 进程级默认域, 有意不析构 (线程退出顺序不确定)
+    static HazardDomain& Global() {
+        static HazardDomain* domain = new HazardDomain;
+        return *domain;
+    }
+
+    template <typename T, typename Deleter = std::default_delete<T>>
+    void Retire(T* ptr, Deleter = {}) {
+        if (!ptr) {
+            return;
+        }
+        Record* record = Local();
+        record->retired_.Push(_Retired{ptr, &_RetiredDelete<T, Deleter>});
+        // NOTE: 阈值随槽位数增长, 保证每次扫描至少能回收一半, 均摊 O(1)
+        if (record->retired_.Size() >= std::max(kMinScanThreshold, 2 * slots_.Count())) {
+            Scan(record);
+        }
+    }
+
+    // 立即扫描并回收本线程 (及已退出线程) 中未被保护的指针, 返回回收个数
+    std::size_t Collect() { return Scan(Local()); }
+
+    // 当前线程待回收的指针个数
+    std::size_t Pending() { return Local()->retired_.Size(); }
+
+private:
+    using Record = _HazardRetireRecord;
+
+    static constexpr std::size_t kMinScanThreshold = 64;
+
+    Record* Local() { return _ThreadRecordCache<HazardDomain, Record>::Get(this); }
+
+    Record* AcquireThreadRecord() { return records_.Acquire(); }
+
+    void ReleaseThreadRecord(Record* record) {
+        Scan(record);
+        if (!record->retired_.Empty()) {
+            std::lock_guard lk{orphans_mtx_};
+            orphans_.Splice(record->retired_);
+            has_orphans_.store(true, std::memory_order_relaxed);
+        }
+        _RecordList<Record>::Release(record);
+    }
+
+    std::size_t Scan(Record* record) {
+        // NOTE: 与 Protect 中的 fence 配对: 要么这里看到读者发布的指针, 要么读者重新检查时看到节点已被摘除
+        _SeqCstFence();
+        std::vector<void*> hazards;
+        hazards.reserve(slots_.Count());
+        slots_.ForEach([&](_HazardSlot& slot) {
+            if (void* p = slot.ptr_.load(std::memory_order_acquire)) {
+                hazards.push_back(p);
+            }
+        });
+        std::sort(hazards.begin(), hazards.end());
+        auto is_protected = [&](void* p) {
+            return std::binary_search(hazards.begin(), hazards.end(), p);
+        };
+        std::size_t reclaimed = record->retired_.ReclaimUnless(is_protected);
+        if (has_orphans_.load(std::memory_order_relaxed)) {
+            std::lock_guard lk{orphans_mtx_};
+            reclaimed += orphans_.ReclaimUnless(is_protected);
+            has_orphans_.store(!orphans_.Empty(), std::memory_order_relaxed);
+        }
+        return reclaimed;
+    }
+
+    _RecordList<_HazardSlot> slots_;
+    _RecordList<Record> records_;
+    std::mutex orphans_mtx_;
+    std::atomic<bool> has_orphans_{false};
+    _RetiredList orphans_;  // 已退出线程留下的退休指针
+    std::shared_ptr<_DomainLife> life_{std::make_shared<_DomainLife>()};  // 见 _ThreadRecordCache
+};
+
+// 独占一个危险指针槽位; 同一时刻保护一个指针
+class HazardPointer {
+public:
+    explicit HazardPointer(HazardDomain& domain = HazardDomain::Global())
+        : slot_(domain.slots_.Acquire()) {}
+
+    HazardPointer(HazardPointer const&) = delete;
+    HazardPointer& operator=(HazardPointer const&) = delete;
+
+    ~HazardPointer() {
+        Reset();
+        _RecordList<_HazardSlot>::Release(slot_);
+    }
+
+    // 读取 src 并发布为危险指针, 直到读到的值稳定 (发布后 src 未变化)
+    template <typename T>
+    T* Protect(std::atomic<T*> const& src) noexcept {
+        T* ptr = src.load(std::memory_order_relaxed);
+        while (true) {
+            slot_->ptr_.store(ptr, std::memory_order_relaxed);
+            // HACK: store-load 屏障, 保证发布先于重新检查对回收线程可见
+            _SeqCstFence();
+            T* again = src.load(std::memory_order_acquire);
+            if (again == ptr) {
+                return ptr;
+            }
+            ptr = again;
+        }
+    }
+
+    // 直接发布一个已知仍然存活的指针 (例如已被另一个危险指针保护)
+    template <typename T>
+    void Set(T* ptr) noexcept {
+        slot_->ptr_.store(ptr, std::memory_order_relaxed);
+        _SeqCstFence();
+    }
+
+    void Reset() noexcept { slot_->ptr_.store(nullptr, std::memory_order_release); }
+
+private:
+    _HazardSlot* slot_;
+};
+
+}  // namespace cutestl
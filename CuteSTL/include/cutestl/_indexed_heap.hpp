@@ -0,0 +1,251 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#include "vector.hpp"
+
+// 带句柄的 d 叉堆 (默认 4 叉): Push 返回句柄, 之后可以凭句柄改优先级 (DecreaseKey) 或删除
+// 用法 (Dijkstra):
+//   IndexedHeap<std::pair<Dist, Node>> open;
+//   handle[v] = open.Push({d, v});
+//   open.DecreaseKey(handle[v], {shorter, v});
+//   auto [d, u] = open.Pop();
+//
+// NOTE: Top() 是 Compare 意义下 "最小" 的元素 (与 PriorityQueue 相反), 适合计时器与最短路;
+// 需要最大堆时传 std::greater<T>
+// NOTE: 为什么是 4 叉
+// - 树高减半 (log4 n), 上浮 (Push / DecreaseKey) 的比较与移动次数减半
+// - 下沉 (Pop) 每层比较 4 个孩子, 但 4 个孩子在数组里相邻, 通常落在同一条缓存行里,
+//   多出的比较几乎不带来额外的缓存未命中
+// NOTE: 元素与它的槽位编号放在一起 (Node), 比较时不需要经由句柄表间接访问;
+// 句柄表只在移动元素时更新位置
+// NOTE: 句柄带有代数 (generation), 元素被 Pop / Erase 后槽位可以复用, 旧句柄 Contains() 为 false
+
+namespace cutestl {
+
+template <typename T, typename Compare = std::less<T>, std::size_t Arity = 4>
+class IndexedHeap {
+    static_assert(Arity >= 2, "Arity 至少为 2");
+
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+
+    class Handle {
+    public:
+        Handle() noexcept = default;
+
+        bool operator==(Handle const&) const noexcept = default;
+
+    private:
+        friend class IndexedHeap;
+
+        Handle(std::uint32_t slot, std::uint32_t generation) noexcept
+            : slot_(slot), generation_(generation) {}
+
+        std::uint32_t slot_{kNone};
+        std::uint32_t generation_{0};
+    };
+
+public:
+    IndexedHeap() = default;
+
+    explicit IndexedHeap(Compare const& comp) : comp_(comp) {}
+
+public:
+    bool Empty() const { return heap_.Empty(); }
+
+    size_type Size() const { return heap_.Size(); }
+
+    T const& Top() const {
+        assert(!Empty());
+        return heap_[0].value_;
+    }
+
+    Handle TopHandle() const {
+        assert(!Empty());
+        return HandleOf(heap_[0].slot_);
+    }
+
+    // 句柄指向的元素是否还在堆里
+    bool Contains(Handle handle) const {
+        return handle.slot_ < slots_.Size() &&
+               slots_[handle.slot_].generation_ == handle.generation_ &&
+               slots_[handle.slot_].pos_ != kNone;
+    }
+
+    T const& Get(Handle handle) const {
+        assert(Contains(handle));
+        return heap_[slots_[handle.slot_].pos_].value_;
+    }
+
+    template <typename... Args>
+    Handle Emplace(Args&&... args) {
+        std::uint32_t slot = AcquireSlot();
+        heap_.PushBack(Node{T(std::forward<Args>(args)...), slot});
+        SiftUp(Size() - 1);
+        return HandleOf(slot);
+    }
+
+    Handle Push(T const& value) { return Emplace(value); }
+
+    Handle Push(T&& value) { return Emplace(std::move(value)); }
+
+    // 取出堆顶
+    T Pop() {
+        assert(!Empty());
+        return RemoveAt(0);
+    }
+
+    // 新值不能比原值 "大" (只会上浮)
+    void DecreaseKey(Handle handle, T value) {
+        assert(Contains(handle));
+        size_type pos = slots_[handle.slot_].pos_;
+        assert(!comp_(heap_[pos].value_, value) && "DecreaseKey 的新值比原值大");
+        heap_[pos].value_ = std::move(value);
+        SiftUp(pos);
+    }
+
+    // 新值不能比原值 "小" (只会下沉)
+    void IncreaseKey(Handle handle, T value) {
+        assert(Contains(handle));
+        size_type pos = slots_[handle.slot_].pos_;
+        assert(!comp_(value, heap_[pos].value_) && "IncreaseKey 的新值比原值小");
+        heap_[pos].value_ = std::move(value);
+        SiftDown(pos);
+    }
+
+    // 任意方向修改优先级
+    void Update(Handle handle, T value) {
+        assert(Contains(handle));
+        size_type pos = slots_[handle.slot_].pos_;
+        bool up = comp_(value, heap_[pos].value_);
+        heap_[pos].value_ = std::move(value);
+        up ? SiftUp(pos) : SiftDown(pos);
+    }
+
+    // 删除句柄指向的元素并返回它
+    T Erase(Handle handle) {
+        assert(Contains(handle));
+        return RemoveAt(slots_[handle.slot_].pos_);
+    }
+
+    void Clear() {
+        for (size_type i = 0; i < Size(); ++i) {
+            ReleaseSlot(heap_[i].slot_);
+        }
+        heap_.Clear();
+    }
+
+    void Reserve(size_type n) {
+        heap_.Reserve(n);
+        slots_.Reserve(n);
+    }
+
+private:
+    static constexpr std::uint32_t kNone = static_cast<std::uint32_t>(-1);
+
+    struct Node {
+        T value_;
+        std::uint32_t slot_;
+    };
+
+    // 句柄表: 槽位 -> 堆中位置; 空闲槽位的 pos_ 为 kNone
+    struct Slot {
+        std::uint32_t pos_;
+        std::uint32_t generation_;
+    };
+
+    static size_type Parent(size_type i) noexcept { return (i - 1) / Arity; }
+
+    Handle HandleOf(std::uint32_t slot) const noexcept {
+        return Handle{slot, slots_[slot].generation_};
+    }
+
+    std::uint32_t AcquireSlot() {
+        if (!free_.Empty()) {
+            std::uint32_t slot = free_.Back();
+            free_.PopBack();
+            return slot;
+        }
+        assert(slots_.Size() < kNone);
+        slots_.PushBack(Slot{kNone, 0});
+        return static_cast<std::uint32_t>(slots_.Size() - 1);
+    }
+
+    void ReleaseSlot(std::uint32_t slot) {
+        slots_[slot].pos_ = kNone;
+        ++slots_[slot].generation_;
+        free_.PushBack(slot);
+    }
+
+    // 把 node 放到 pos 并更新句柄表
+    void Place(size_type pos, Node&& node) {
+        slots_[node.slot_].pos_ = static_cast<std::uint32_t>(pos);
+        heap_[pos] = std::move(node);
+    }
+
+    T RemoveAt(size_type pos) {
+        Node removed{std::move(heap_[pos])};
+        ReleaseSlot(removed.slot_);
+        size_type last = Size() - 1;
+        if (pos != last) {
+            // 用最后一个元素填补空位, 它可能需要上浮也可能需要下沉
+            Place(pos, std::move(heap_[last]));
+            heap_.PopBack();
+            if (pos > 0 && comp_(heap_[pos].value_, heap_[Parent(pos)].value_)) {
+                SiftUp(pos);
+            } else {
+                SiftDown(pos);
+            }
+        } else {
+            heap_.PopBack();
+        }
+        return std::move(removed.value_);
+    }
+
+    void SiftUp(size_type hole) {
+        Node node{std::move(heap_[hole])};
+        while (hole > 0 && comp_(node.value_, heap_[Parent(hole)].value_)) {
+            Place(hole, std::move(heap_[Parent(hole)]));
+            hole = Parent(hole);
+        }
+        Place(hole, std::move(node));
+    }
+
+    void SiftDown(size_type hole) {
+        Node node{std::move(heap_[hole])};
+        size_type size = Size();
+        while (true) {
+            size_type first = hole * Arity + 1;
+            if (first >= size) {
+                break;
+            }
+            size_type last = first + Arity < size ? first + Arity : size;
+            size_type best = first;
+            for (size_type child = first + 1; child < last; ++child) {
+                if (comp_(heap_[child].value_, heap_[best].value_)) {
+                    best = child;
+                }
+            }
+            if (!comp_(heap_[best].value_, node.value_)) {
+                break;
+            }
+            Place(hole, std::move(heap_[best]));
+            hole = best;
+        }
+        Place(hole, std::move(node));
+    }
+
+    Vector<Node> heap_;
+    Vector<Slot> slots_;
+    Vector<std::uint32_t> free_;  // 空闲槽位
+    [[no_unique_address]] Compare comp_;
+};
+
+}  // namespace cutestl
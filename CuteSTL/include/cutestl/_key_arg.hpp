@@ -0,0 +1,25 @@
+#pragma once
+
+// 异构查找: 比较器 (或哈希与相等比较) 是透明的时候, 查找函数接受任意键类型 Q, 否则只接受 Key
+// 用法:
+//   template <typename Q>
+//   using KeyArg = typename _KeyArg<kTransparent>::template type<Q, key_type>;
+//   template <typename Q = key_type>
+//   iterator Find(KeyArg<Q> const& key);
+// HACK: 用成员别名模板而不是 std::conditional_t, 这样 Q 仍然可以从实参推导
+
+namespace cutestl {
+
+template <bool kTransparent>
+struct _KeyArg {
+    template <typename Q, typename Key>
+    using type = Key;
+};
+
+template <>
+struct _KeyArg<true> {
+    template <typename Q, typename Key>
+    using type = Q;
+};
+
+}  // namespace cutestl
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// 低开销的度量工具
+//   * LogHistogram: HDR 风格的对数分桶直方图 (每个 2 的幂区间再细分 8 个子桶, 相对误差 <= 12.5%)
+//   * 单写者设计: 每个工作线程只写自己的直方图, 用 relaxed load + store 代替加锁的 RMW 指令
+//   * 读者随时可以拷贝出快照 (HistogramSnapshot) 并合并、求分位数
+
+namespace cutestl {
+
+// 直方图快照: 普通整数数组, 可合并、可求分位数
+class HistogramSnapshot {
+public:
+    static constexpr unsigned kSubBucketBits = 3;
+    static constexpr std::uint64_t kSubBucketCount = std::uint64_t{1} << kSubBucketBits;
+    static constexpr std::size_t kBucketCount = (65 - kSubBucketBits) << kSubBucketBits;
+
+    // 值 -> 桶下标
+    static constexpr std::size_t BucketIndex(std::uint64_t value) noexcept {
+        unsigned msb = static_cast<unsigned>(std::bit_width(value));  // 最高位 + 1
+        if (msb <= kSubBucketBits) {
+            return static_cast<std::size_t>(value);  // 小值精确计数
+        }
+        unsigned shift = msb - 1 - kSubBucketBits;
+        return (static_cast<std::size_t>(shift + 1) << kSubBucketBits) |
+               static_cast<std::size_t>((value >> shift) & (kSubBucketCount - 1));
+    }
+
+    // 桶下标 -> 该桶覆盖的最大值
+    static constexpr std::uint64_t BucketUpperBound(std::size_t index) noexcept {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        unsigned shift = static_cast<unsigned>(index >> kSubBucketBits) - 1;
+        std::uint64_t sub = (index & (kSubBucketCount - 1)) | kSubBucketCount;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::uint64_t Count() const noexcept { return count_; }
+
+    std::uint64_t Sum() const noexcept { return sum_; }
+
+    double Mean() const noexcept {
+        return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+    }
+
+    // 分位数 (0 ~ 100), 返回所在桶的上界
+    std::uint64_t Percentile(double percentile) const noexcept {
+        if (count_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(percentile / 100.0 * static_cast<double>(count_));
+        if (rank >= count_) {
+            rank = count_ - 1;
+        }
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets_[i];
+            if (seen > rank) {
+                return BucketUpperBound(i);
+            }
+        }
+        return BucketUpperBound(kBucketCount - 1);
+    }
+
+    std::uint64_t BucketCount(std::size_t index) const noexcept { return buckets_[index]; }
+
+    HistogramSnapshot& operator+=(HistogramSnapshot const& other) noexcept {
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+        count_ += other.count_;
+        sum_ += other.sum_;
+        return *this;
+    }
+
+private:
+    friend class LogHistogram;
+
+    std::array<std::uint64_t, kBucketCount> buckets_{};
+    std::uint64_t count_{0};
+    std::uint64_t sum_{0};
+};
+
+// 单写者对数直方图
+class LogHistogram {
+public:
+    // NOTE: 只允许一个线程调用 Record
+    void Record(std::uint64_t value) noexcept {
+        Bump(buckets_[HistogramSnapshot::BucketIndex(value)], 1);
+        Bump(count_, 1);
+        Bump(sum_, value);
+    }
+
+    HistogramSnapshot Snapshot() const noexcept {
+        HistogramSnapshot snapshot;
+        for (std::size_t i = 0; i < HistogramSnapshot::kBucketCount; ++i) {
+            snapshot.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count_ = count_.load(std::memory_order_relaxed);
+        snapshot.sum_ = sum_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    // 单写者自增: 普通的 load + store, 不需要 lock 前缀
+    static void Bump(std::atomic<std::uint64_t>& counter, std::uint64_t delta) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<std::uint64_t>, HistogramSnapshot::kBucketCount> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+};
+
+}  // namespace cutestl
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "_function_storage.hpp"
+
+// 只能移动的 Function: 可以保存 UniquePtr、packaged_task 等只能移动的捕获
+// 与 Function 共用 SBO 存储, 虚表里少了 copy 一项
+
+namespace cutestl {
+
+template <typename FnSig>
+class MoveOnlyFunction {
+    static_assert(!std::is_same_v<FnSig, FnSig>, "函数签名无效!");
+};
+
+template <typename RT, typename... Args>
+class MoveOnlyFunction<RT(Args...)> {
+private:
+    struct VTable {
+        RT (*call_)(void* storage, Args&&... args);
+        void (*move_)(void* dst, void* src) noexcept;
+        void (*destroy_)(void* storage) noexcept;
+    };
+
+    template <typename Fn>
+    struct Handler {
+        using Storage = _FunctionStorage<Fn>;
+
+        // NOTE: RT 为 void 时丢弃仿函数的返回值 (与 std::function 一致)
+        static RT Call(void* storage, Args&&... args) {
+            if constexpr (std::is_void_v<RT>) {
+                std::invoke(*Storage::Get(storage), std::forward<Args>(args)...);
+            } else {
+                return std::invoke(*Storage::Get(storage), std::forward<Args>(args)...);
+            }
+        }
+
+        static constexpr VTable kVTable{&Call, &Storage::Move, &Storage::Destroy};
+    };
+
+    VTable const* vtable_{nullptr};  // 为空表示不持有仿函数
+    _FunctionBuffer storage_;
+
+public:
+    MoveOnlyFunction() = default;
+
+    MoveOnlyFunction(std::nullptr_t) noexcept {}
+
+    // HACK: 不加 explicit 为了 lambda 能隐式转换为 MoveOnlyFunction
+    template <typename Fn,
+              std::enable_if_t<std::is_invocable_r_v<RT, std::decay_t<Fn>&, Args...> &&
+                                   std::is_constructible_v<std::decay_t<Fn>, Fn> &&
+                                   !std::is_same_v<std::decay_t<Fn>, MoveOnlyFunction>,
+                               int> = 0>
+    MoveOnlyFunction(Fn&& f) {
+        using Impl = Handler<std::decay_t<Fn>>;
+        Impl::Storage::Create(storage_.bytes_, std::forward<Fn>(f));
+        vtable_ = &Impl::kVTable;
+    }
+
+    MoveOnlyFunction(MoveOnlyFunction const&) = delete;
+    MoveOnlyFunction& operator=(MoveOnlyFunction const&) = delete;
+
+    MoveOnlyFunction(MoveOnlyFunction&& other) noexcept {
+        if (other.vtable_) {
+            other.vtable_->move_(storage_.bytes_, other.storage_.bytes_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
+        }
+    }
+
+    MoveOnlyFunction& operator=(MoveOnlyFunction&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        Reset();
+        if (other.vtable_) {
+            other.vtable_->move_(storage_.bytes_, other.storage_.bytes_);
+            vtable_ = std::exchange(other.vtable_, nullptr);
+        }
+        return *this;
+    }
+
+    // 释放持有的仿函数 (及其捕获的资源)
+    MoveOnlyFunction& operator=(std::nullptr_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    ~MoveOnlyFunction() { Reset(); }
+
+    explicit operator bool() const noexcept { return vtable_ != nullptr; }
+
+    // NOTE: 非 const, 与 std::move_only_function 一致, 可以调用 mutable lambda
+    RT operator()(Args... args) {
+        if (!vtable_) {
+            throw std::bad_function_call();
+        }
+        return vtable_->call_(storage_.bytes_, std::forward<Args>(args)...);
+    }
+
+private:
+    void Reset() noexcept {
+        if (vtable_) {
+            vtable_->destroy_(storage_.bytes_);
+            vtable_ = nullptr;
+        }
+    }
+};
+
+}  // namespace cutestl
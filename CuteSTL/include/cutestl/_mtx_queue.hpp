@@ -1,19 +1,42 @@
 #pragma once
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
-#include <optional>
 #include <queue>
+#include <utility>
+
+#include "_metrics.hpp"
+#include "optional.hpp"
 
 // 线程安全的有锁队列模板类
 // NOTE: 在并发的生产者-消费者模型中，closed_ 标志位是实现“优雅停机”的标准且核心的实践
 // NOTE: 如果 close 则会处理完队列中的元素 (这是 close‑drain)
 // 其他还有 close-immediate: 直接丢弃
+// NOTE: 度量计数器都在已持有的锁内更新, 不增加额外的原子操作
+// NOTE: 排队等待时间: 入队时在一条平行的 FIFO 里记下时刻, 出队时计入直方图 (各多读一次时钟);
+// 构造时 collect_wait = false 可以关闭
+
+// 队列度量快照
+struct MtxQueueStats {
+    std::uint64_t pushed = 0;    // 成功入队数
+    std::uint64_t popped = 0;    // 成功出队数
+    std::uint64_t rejected = 0;  // 因已关闭、已满或超时而失败的入队数
+    std::size_t depth = 0;       // 当前元素数
+    std::size_t max_depth = 0;   // 历史最大元素数
+    cutestl::HistogramSnapshot wait;  // 排队等待时间 (纳秒)
+};
+
 template <typename T, typename Queue = std::queue<T>>
 class MtxQueue {
+public:
+    class PopAwaiter;
+
 private:
     Queue queue_;
     mutable std::mutex mtx_;
@@ -21,11 +44,21 @@ private:
     std::condition_variable cv_can_pop_;   // 队列非空条件变量
     std::size_t limit_;                    // 最大允许堆积的元素数量
     bool closed_{false};                   // 队列是否已关闭
+    PopAwaiter* waiters_head_{nullptr};    // 挂起在 PopAsync 上的协程 (FIFO 侵入式链表)
+    PopAwaiter* waiters_tail_{nullptr};
+    std::uint64_t pushed_{0};              // 度量: 成功入队数
+    std::uint64_t popped_{0};              // 度量: 成功出队数
+    std::uint64_t rejected_{0};            // 度量: 失败的入队数
+    std::size_t max_depth_{0};             // 度量: 历史最大元素数
+    bool collect_wait_;                    // 是否统计排队等待时间
+    std::queue<std::chrono::steady_clock::time_point> enqueued_;  // 与 queue_ 对应的入队时刻
+    cutestl::LogHistogram wait_;           // 度量: 排队等待时间 (锁内写入, 同一时刻只有一个写者)
 
 public:
     // -1转无符号最大数
     // 指定最大允许堆积的元素数量，超过该数量后会阻塞
-    explicit MtxQueue(std::size_t limit = static_cast<std::size_t>(-1)) : limit_(limit) {
+    explicit MtxQueue(std::size_t limit = static_cast<std::size_t>(-1), bool collect_wait = true)
+        : limit_(limit), collect_wait_(collect_wait) {
         assert(limit_ > 0 && "limit must be > 0");  // limit > 0
     }
     MtxQueue(const MtxQueue&) = delete;  // 禁止拷贝
@@ -37,8 +70,59 @@ public:
         closed_ = true;
         cv_can_push_.notify_all();
         cv_can_pop_.notify_all();
+        // NOTE: 此时队列必为空 (有挂起协程说明之前队列为空), 挂起的协程都以 nullopt 恢复
+        PopAwaiter* waiter = std::exchange(waiters_head_, nullptr);
+        waiters_tail_ = nullptr;
+        lk.unlock();
+        while (waiter) {
+            PopAwaiter* next = waiter->next_;  // NOTE: 恢复后 waiter 所在协程帧可能已销毁
+            waiter->handle_.resume();
+            waiter = next;
+        }
     }
 
+    // co_await queue.PopAsync(): 协程版 Pop, 队列为空时挂起协程而不是阻塞线程
+    // 返回值语义同 Pop: 关闭且为空时得到 nullopt
+    // NOTE: 协程在随后调用 Push/Close 的线程上恢复, 需要时可再 co_await pool.Schedule()
+    class PopAwaiter {
+    public:
+        explicit PopAwaiter(MtxQueue* queue) noexcept : queue_(queue) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            std::unique_lock lk{queue_->mtx_};
+            if (!queue_->queue_.empty()) {  // 有元素, 直接取走不挂起
+                value_.Emplace(queue_->TakeFront());
+                queue_->cv_can_push_.notify_one();
+                return false;
+            }
+            if (queue_->closed_) {
+                return false;
+            }
+            handle_ = h;
+            if (queue_->waiters_tail_) {
+                queue_->waiters_tail_->next_ = this;
+            } else {
+                queue_->waiters_head_ = this;
+            }
+            queue_->waiters_tail_ = this;
+            return true;
+        }
+
+        cutestl::Optional<T> await_resume() { return std::move(value_); }
+
+    private:
+        friend class MtxQueue;
+
+        MtxQueue* queue_;
+        cutestl::Optional<T> value_;
+        std::coroutine_handle<> handle_;
+        PopAwaiter* next_{nullptr};
+    };
+
+    [[nodiscard]] PopAwaiter PopAsync() noexcept { return PopAwaiter{this}; }
+
 public:
     // 阻塞 Push (左值)
     bool Push(const T& value) { return Emplace(value); }
@@ -82,11 +166,12 @@ public:
         std::unique_lock lk{mtx_};
         cv_can_push_.wait(lk, [this] { return closed_ || queue_.size() < limit_; });
         if (closed_) {
+            ++rejected_;
             return false;
         }
         // NOTE: 完美转发 + 原地构造, 避免拷贝/移动
         queue_.emplace(std::forward<Args>(args)...);
-        cv_can_pop_.notify_one();  // 通知可取
+        HandOffOrNotify(lk);  // 通知可取
         return true;
     }
 
@@ -95,10 +180,11 @@ public:
     bool TryEmplace(Args&&... args) {
         std::unique_lock lk{mtx_};
         if (closed_ || queue_.size() >= limit_) {
+            ++rejected_;
             return false;
         }
         queue_.emplace(std::forward<Args>(args)...);
-        cv_can_pop_.notify_one();
+        HandOffOrNotify(lk);
         return true;
     }
 
@@ -108,13 +194,15 @@ public:
         std::unique_lock lk{mtx_};
         if (!cv_can_push_.wait_for(lk, duration,
                                    [this] { return closed_ || queue_.size() < limit_; })) {
+            ++rejected_;
             return false;
         }
         if (closed_) {
+            ++rejected_;
             return false;
         }
         queue_.emplace(std::forward<Args>(args)...);
-        cv_can_pop_.notify_one();
+        HandOffOrNotify(lk);
         return true;
     }
 
@@ -125,70 +213,68 @@ public:
         std::unique_lock lk{mtx_};
         if (!cv_can_push_.wait_until(lk, time_point,
                                      [this] { return closed_ || queue_.size() < limit_; })) {
+            ++rejected_;
             return false;
         }
         if (closed_) {
+            ++rejected_;
             return false;
         }
         queue_.emplace(std::forward<Args>(args)...);
-        cv_can_pop_.notify_one();
+        HandOffOrNotify(lk);
         return true;
     }
 
     // 阻塞 Pop
-    std::optional<T> Pop() {
+    cutestl::Optional<T> Pop() {
         std::unique_lock lk{mtx_};
         cv_can_pop_.wait(lk, [this] { return closed_ || !queue_.empty(); });  // 等待可取
         if (queue_.empty()) {                                                 // 为空且已关闭
-            return std::nullopt;
+            return cutestl::nullopt;
         }
-        T value{std::move(queue_.front())};
-        queue_.pop();
+        T value{TakeFront()};
         cv_can_push_.notify_one();
         return value;
     }
 
     // 非阻塞 Pop
-    std::optional<T> TryPop() {
+    cutestl::Optional<T> TryPop() {
         std::unique_lock lk{mtx_};
         if (queue_.empty()) {
-            return std::nullopt;
+            return cutestl::nullopt;
         }
-        T value{std::move(queue_.front())};
-        queue_.pop();
+        T value{TakeFront()};
         cv_can_push_.notify_one();
         return value;
     }
 
     // 限时 Pop (时间段)
     template <typename Rep, typename Period>
-    std::optional<T> TryPopFor(std::chrono::duration<Rep, Period> const& duration) {
+    cutestl::Optional<T> TryPopFor(std::chrono::duration<Rep, Period> const& duration) {
         std::unique_lock lk{mtx_};
         if (!cv_can_pop_.wait_for(lk, duration, [this] { return closed_ || !queue_.empty(); })) {
-            return std::nullopt;
+            return cutestl::nullopt;
         }
         if (queue_.empty()) {  //  NOTE: 为空且已关闭
-            return std::nullopt;
+            return cutestl::nullopt;
         }
-        T value{std::move(queue_.front())};
-        queue_.pop();
+        T value{TakeFront()};
         cv_can_push_.notify_one();
         return value;
     }
 
     // 限时 Pop (时间点)
     template <typename Clock, typename Duration>
-    std::optional<T> TryPopUntil(std::chrono::time_point<Clock, Duration> const& time_point) {
+    cutestl::Optional<T> TryPopUntil(std::chrono::time_point<Clock, Duration> const& time_point) {
         std::unique_lock lk{mtx_};
         if (!cv_can_pop_.wait_until(lk, time_point,
                                     [this] { return closed_ || !queue_.empty(); })) {
-            return std::nullopt;
+            return cutestl::nullopt;
         }
         if (queue_.empty()) {  //  NOTE: 为空且已关闭
-            return std::nullopt;
+            return cutestl::nullopt;
         }
-        T value{std::move(queue_.front())};
-        queue_.pop();
+        T value{TakeFront()};
         cv_can_push_.notify_one();
         return value;
     }
@@ -203,9 +289,52 @@ public:
         return queue_.size();
     }
 
+    MtxQueueStats Stats() const {
+        std::lock_guard lk{mtx_};
+        return MtxQueueStats{pushed_, popped_, rejected_, queue_.size(), max_depth_,
+                             wait_.Snapshot()};
+    }
+
     void Clear() {
         std::lock_guard lk{mtx_};
         Queue{}.swap(queue_);  // copy-swap
+        std::queue<std::chrono::steady_clock::time_point>{}.swap(enqueued_);
         cv_can_push_.notify_all();
     }
+
+private:
+    // 新元素入队后: 有挂起的协程则直接交给它并在锁外恢复, 否则唤醒一个阻塞的 Pop
+    void HandOffOrNotify(std::unique_lock<std::mutex>& lk) {
+        ++pushed_;
+        if (collect_wait_) {
+            enqueued_.push(std::chrono::steady_clock::now());
+        }
+        max_depth_ = std::max(max_depth_, queue_.size());
+        PopAwaiter* waiter = waiters_head_;
+        if (!waiter) {
+            cv_can_pop_.notify_one();
+            return;
+        }
+        waiters_head_ = waiter->next_;
+        if (!waiters_head_) {
+            waiters_tail_ = nullptr;
+        }
+        waiter->value_.Emplace(TakeFront());
+        lk.unlock();
+        waiter->handle_.resume();
+    }
+
+    // 取出队头 (需持有锁), 同时记录它的排队等待时间
+    T TakeFront() {
+        T value{std::move(queue_.front())};
+        queue_.pop();
+        ++popped_;
+        if (collect_wait_) {
+            auto wait = std::chrono::steady_clock::now() - enqueued_.front();
+            enqueued_.pop();
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wait).count();
+            wait_.Record(ns > 0 ? static_cast<std::uint64_t>(ns) : 0);
+        }
+        return value;
+    }
 };
\ No newline at end of file
@@ -1,33 +1,150 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <coroutine>
 #include <cstddef>
+#include <cstdint>
+#include <exception>
 #include <functional>
 #include <future>
 #include <mutex>
 #include <queue>
 #include <stdexcept>
+#include <stop_token>
 #include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
-// C++17/20 实现的一个简单、可靠的固定大小线程池
+#include "_hardware.hpp"
+#include "_metrics.hpp"
+#include "_move_only_function.hpp"
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// C++17/20 实现的一个简单、可靠的线程池 (默认固定大小, 可选弹性伸缩)
 // 特性：
 //   * Submit 任意可调用对象，返回 std::future<R>
 //   * 析构或 Shutdown() 会阻止新任务并等待工作线程退出
 //   * 异常在 future.get() 时重新抛出
+//   * co_await Schedule()/ScheduleAfter() 把协程切换到工作线程 (或延时后) 恢复
+//   * 按优先级分道 (lane) 排队, 低优先级任务等待过久会被老化提升, 避免饿死
+//   * 可选的工作线程 CPU 绑定与单个任务的线程亲和提示
+//   * 弹性模式: 线程数在 [thread_count, max_threads] 间伸缩, 多出的线程空闲超时后退出
+//   * 空闲线程先指数退避自旋再休眠; 有线程在自旋时提交任务不触发 futex 唤醒,
+//     由取到任务的线程在还有剩余任务时接力唤醒休眠线程
+//   * 内置度量: 提交/完成计数、队列深度、排队等待与执行时间直方图, Stats() 获取快照
+//   * 协作式取消: 任务可接收 std::stop_token; 超过截止时间或已取消的任务出队后直接跳过
+//   * Shutdown() 执行完所有排队任务再退出; ShutdownNow() 丢弃排队任务并请求正在运行的任务停止
 namespace cutestl {
+
+// 任务在执行前被取消, 由 future.get() 抛出: 出队时调用方的 stop_token 已触发、已超过截止时间,
+// 或者工作线程取出任务后、开始执行前线程池被 ShutdownNow (仍在队列里的任务见 ShutdownNow)
+struct TaskCancelled : public std::exception {
+    const char* what() const noexcept override { return "TaskCancelled"; }
+};
+
+// 任务优先级: 数值越小越优先
+enum class TaskPriority : std::uint8_t {
+    kCritical = 0,    // 延迟敏感 (面向用户的请求)
+    kNormal = 1,      // 默认
+    kBackground = 2,  // 后台 (压缩、清理等)
+};
+
+inline constexpr std::size_t kTaskPriorityCount = 3;
+
+// std::invoke_result 的变体: f 的第一个参数可以是 std::stop_token (由线程池提供)
+template <class F, class... Args>
+struct _TaskResultImpl : std::invoke_result<F, Args...> {};
+
+template <class F, class... Args>
+    requires std::is_invocable_v<F, std::stop_token, Args...>
+struct _TaskResultImpl<F, Args...> : std::invoke_result<F, std::stop_token, Args...> {};
+
+template <class F, class... Args>
+using _TaskResult = typename _TaskResultImpl<F, Args...>::type;
+
+// 单个任务的提交选项
+struct TaskOptions {
+    static constexpr std::size_t kAnyWorker = static_cast<std::size_t>(-1);
+
+    TaskPriority priority = TaskPriority::kNormal;
+    // 亲和提示: 指定由第几个工作线程执行 (配合 CPU 绑定可让任务留在固定核上, 复用缓存)
+    std::size_t worker = kAnyWorker;
+    // 调用方的取消令牌: 出队时已请求停止则跳过; 运行中的任务可通过 stop_token 参数观察
+    std::stop_token stop_token;
+    // 截止时间: 出队时已超过则跳过, 不再浪费线程执行过期请求
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+};
+
+// CPU 集合: CPU 编号列表
+using CpuSet = std::vector<int>;
+
+// 线程池配置
+struct ThreadPoolOptions {
+    // 常驻 (最少) 线程数
+    std::size_t thread_count = std::thread::hardware_concurrency();
+    // 最多线程数, 0 表示与 thread_count 相同 (固定大小)
+    std::size_t max_threads = 0;
+    // 超出 thread_count 的线程空闲超过该时长后退出
+    std::chrono::steady_clock::duration idle_timeout = std::chrono::seconds{10};
+    // 休眠前的自旋退避步数 (见 Backoff), 0 表示不自旋直接休眠
+    std::uint32_t spin_limit = 10;
+    // 防饥饿老化阈值: 低优先级任务在队头等待超过该时长后, 可以插到高优先级任务前面执行
+    std::chrono::steady_clock::duration aging = std::chrono::milliseconds{200};
+    // 老化任务最多每 aging_interval 次出队插队一次, 其余出队仍按优先级;
+    // 高优先级任务因此最多被推迟 1/aging_interval 的吞吐, 不会被老化的积压反过来饿死
+    std::uint32_t aging_interval = 8;
+    // 可选的 CPU 绑定: 第 i 个工作线程绑定到 worker_cpus[i % size()]
+    std::vector<CpuSet> worker_cpus;
+    // 是否统计排队等待与执行时间 (每个任务多读两次时钟)
+    bool collect_latency = true;
+};
+
+// 线程池度量快照
+struct ThreadPoolStats {
+    std::uint64_t submitted = 0;                      // 已提交任务数 (含协程恢复)
+    std::uint64_t completed = 0;                      // 已完成任务数
+    std::size_t queue_depth = 0;                      // 当前排队任务数
+    std::size_t live_workers = 0;                     // 当前存活线程数
+    std::vector<std::uint64_t> completed_per_worker;  // 按线程槽位统计的完成数
+    HistogramSnapshot queue_wait;                     // 排队等待时间 (纳秒)
+    HistogramSnapshot run_time;                       // 执行时间 (纳秒)
+};
+
 class ThreadPool {
 public:
-    explicit ThreadPool(std::size_t thread_count) : stopping_(false) {
-        if (thread_count == 0) {
+    explicit ThreadPool(std::size_t thread_count) : ThreadPool(DefaultOptions(thread_count)) {}
+
+    explicit ThreadPool(ThreadPoolOptions const& options)
+        : core_count_(options.thread_count),
+          max_count_(std::max(options.thread_count, options.max_threads)),
+          idle_timeout_(options.idle_timeout),
+          spin_limit_(options.spin_limit),
+          aging_(options.aging),
+          aging_interval_(std::max<std::uint32_t>(options.aging_interval, 1)),
+          worker_cpus_(options.worker_cpus),
+          collect_latency_(options.collect_latency),
+          metrics_(max_count_),
+          affine_(options.thread_count),
+          live_(max_count_, false),
+          stopping_(false) {
+        if (options.thread_count == 0) {
             throw std::invalid_argument("thread_count must be > 0");
         }
-        workers_.reserve(thread_count);
+        // NOTE: 槽位一次分配好, 弹性线程复用空闲槽位, 下标 (worker id) 保持稳定
+        workers_.resize(max_count_);
         try {
-            for (std::size_t i = 0; i < thread_count; ++i) {
-                workers_.emplace_back([this] {
-                    this->WorkerLoop();  // 启动工作线程循环
-                });
+            std::lock_guard lk{mtx_};
+            for (std::size_t i = 0; i < core_count_; ++i) {
+                SpawnWorker(i);
             }
         } catch (...) {
             // 如果部分线程已创建，确保清理。
@@ -44,79 +161,552 @@ public:
 
     // 提交任务：接受任意可调用与参数，返回 future<返回类型>。
     template <class F, class... Args>
-    auto Submit(F&& f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
-        using R = std::invoke_result_t<F, Args...>;
+    auto Submit(F&& f, Args&&... args) -> std::future<_TaskResult<F, Args...>> {
+        return Submit(TaskOptions{}, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // 带截止时间提交: 出队时已超过 deadline 则不执行, future.get() 抛出 TaskCancelled
+    template <class F, class... Args>
+    auto Submit(std::chrono::steady_clock::time_point deadline, F&& f, Args&&... args)
+        -> std::future<_TaskResult<F, Args...>> {
+        TaskOptions options;
+        options.deadline = deadline;
+        return Submit(options, std::forward<F>(f), std::forward<Args>(args)...);
+    }
+
+    // 带选项提交: pool.Submit({.priority = TaskPriority::kCritical}, f, args...)
+    // 如果 f 的第一个参数是 std::stop_token, 会传入一个在调用方取消或 ShutdownNow 时触发的令牌
+    template <class F, class... Args>
+    auto Submit(TaskOptions const& options, F&& f, Args&&... args)
+        -> std::future<_TaskResult<F, Args...>> {
+        using R = _TaskResult<F, Args...>;
 
         // 把原本需要参数的可调用对象 f 与它的参数 args... 预先“拼”好, 变成一个“无参可调用对象”
         // 并用 packaged_task 包装以拿到 future。
         // 用 lambda + apply 避免 std::bind 的语义惊喜，完美转发并保持移动
-        auto packer = [fn = std::forward<F>(f),
-                       tup = std::make_tuple(std::forward<Args>(args)...)]() mutable -> R {
-            return std::apply(std::move(fn), std::move(tup));
+        // NOTE: 唯一的参数是线程池的 stop_token, 只在 ShutdownNow 时触发;
+        // Shutdown 和析构不触发它, 排队中的任务照常执行
+        auto packer = [fn = std::forward<F>(f), tup = std::make_tuple(std::forward<Args>(args)...),
+                       token = options.stop_token, deadline = options.deadline](
+                          std::stop_token const& pool_token) mutable -> R {
+            if (pool_token.stop_requested() || token.stop_requested() ||
+                (deadline != Clock::time_point::max() && Clock::now() > deadline)) {
+                throw TaskCancelled{};  // 跳过执行
+            }
+            if constexpr (std::is_invocable_v<F, std::stop_token, Args...>) {
+                auto run = [&](std::stop_token st) -> R {
+                    auto full = std::tuple_cat(std::make_tuple(std::move(st)), std::move(tup));
+                    return std::apply(std::move(fn), std::move(full));
+                };
+                if (!token.stop_possible()) {
+                    return run(pool_token);
+                }
+                // 调用方令牌与线程池令牌任一触发, 都转发给任务看到的令牌
+                std::stop_source merged;
+                std::stop_callback on_caller{token, [&merged] { merged.request_stop(); }};
+                std::stop_callback on_pool{pool_token, [&merged] { merged.request_stop(); }};
+                return run(merged.get_token());
+            } else {
+                return std::apply(std::move(fn), std::move(tup));
+            }
         };
 
         // std::promise + std::future：手动设置结果
         // std::packaged_task + std::future：任务执行后自动产生结果
         // 执行 packaged_task 相当于执行它内部的函数，并自动将结果放入 future 对象中
 
-        // HACK: packaged_task 只能移动, 不能拷贝, 所以需要智能指针包装
-        // 不然 lambda 里面只能引用捕获, 但是 packaged_task 栈上变量离开作用域自动销毁, 造成悬垂引用
-        // 此外, 任务队列是 std::function, 它具有值语义, 要求所包装的可调用对象必须是可拷贝构造的
-        auto task = std::make_shared<std::packaged_task<R()>>(std::move(packer));
-        std::future<R> fut = task->get_future();  // 获取 future (因为 task 可能在其他线程被调用)
+        // NOTE: packaged_task 只能移动, 任务队列用 MoveOnlyFunction 直接保存它,
+        // 不必再用 shared_ptr 包一层 (packaged_task 只有一个指针大, 放得进 SBO 缓冲区)
+        using PackagedTask = std::packaged_task<R(std::stop_token const&)>;
+        PackagedTask task{std::move(packer)};
+        std::future<R> fut = task.get_future();  // 获取 future (因为 task 可能在其他线程被调用)
 
-        {
-            std::lock_guard lk{mtx_};
-            if (stopping_) {
-                throw std::runtime_error("ThreadPool is stopping; cannot submit.");
-            }
-            // NOTE: 将 task 包装为无参<void()>任务，并添加到任务队列
-            // 在工作线程中执行任务。异常由 packaged_task 捕获并传递给 future。
-            tasks_.emplace([task]() noexcept { (*task)(); });
-        }
-        cv_.notify_one();
+        // NOTE: 将 task 包装为 <void(stop_token)> 任务，并添加到任务队列
+        // 在工作线程中执行任务。异常由 packaged_task 捕获并传递给 future。
+        Enqueue(options,
+                [task = std::move(task)](std::stop_token const& st) mutable noexcept { task(st); },
+                true);
         return fut;
     }
 
+    // 提交不关心结果的任务: 不创建 packaged_task 与 future, 比 Submit 少一次共享状态的分配,
+    // 适合定时器回调这类高频的小任务. ShutdownNow 时与 Submit 的任务一样会被丢弃
+    // NOTE: 没有 future 可以传递异常, f 抛出异常时 std::terminate
+    template <class F>
+        requires std::is_invocable_v<std::decay_t<F>&>
+    void Post(F&& f, TaskPriority priority = TaskPriority::kNormal) {
+        TaskOptions options;
+        options.priority = priority;
+        Enqueue(options,
+                [fn = std::forward<F>(f)](std::stop_token const&) mutable noexcept { fn(); },
+                true);
+    }
+
     // 显式关停：阻止新任务、等待队列清空并回收线程。
     void Shutdown() noexcept {
+        std::vector<std::jthread> workers;
         {
             std::lock_guard lk{mtx_};
             if (stopping_) {  // 如果已经停止，直接返回
                 return;
             }
             stopping_ = true;  // 设置停止标志
+            // NOTE: 在锁内移出线程槽位, 在锁外 join; 并发的 SetWorkerAffinity 只会看到空表
+            workers.swap(workers_);
+        }
+        cv_.notify_all();
+        workers.clear();  // 回收工作线程 (jthread 会自动 join, 包括已退出的弹性线程)
+    }
+
+    // 立即关停：阻止新任务、丢弃排队中的任务, 并通过 stop_token 请求正在运行的任务停止。
+    // 仍在队列里被丢弃的任务, future.get() 抛出 std::future_error (broken_promise);
+    // 已被工作线程取出、尚未开始执行的任务抛出 TaskCancelled。返回丢弃的任务数。
+    // NOTE: 协程恢复与定时器不会被丢弃, 仍会执行以便协程收尾
+    std::size_t ShutdownNow() noexcept {
+        Lanes dropped;
+        std::vector<Lanes> dropped_affine(affine_.size());
+        std::vector<std::jthread> workers;
+        std::size_t discarded = 0;
+        {
+            std::lock_guard lk{mtx_};
+            if (stopping_) {
+                return 0;
+            }
+            stopping_ = true;
+            workers.swap(workers_);  // 同 Shutdown: 锁内移出, 锁外 join
+            discarded += DrainCancellable(lanes_, dropped);
+            for (std::size_t i = 0; i < affine_.size(); ++i) {
+                discarded += DrainCancellable(affine_[i], dropped_affine[i]);
+            }
+            pending_.fetch_sub(discarded, std::memory_order_relaxed);
         }
+        // NOTE: 在锁外触发, 任务注册的 stop_callback 可能回调线程池
+        shutdown_now_.request_stop();  // 运行中的任务经 stop_token 观察到停止
+        // NOTE: 在锁外销毁被丢弃的任务 (packaged_task 析构会设置 future 的异常状态)
+        dropped = Lanes{};
+        dropped_affine.clear();
         cv_.notify_all();
-        workers_.clear();  // 清空工作线程 (jthread 会自动 join)
+        workers.clear();
+        return discarded;
+    }
+
+    // 当前存活的工作线程数
+    std::size_t Size() const noexcept { return live_count_.load(std::memory_order_relaxed); }
+
+    // 度量快照: 计数器由各工作线程分别写入, 这里逐个读出后汇总
+    ThreadPoolStats Stats() const {
+        ThreadPoolStats stats;
+        {
+            std::lock_guard lk{mtx_};
+            stats.submitted = submitted_;
+        }
+        stats.queue_depth = pending_.load(std::memory_order_relaxed);
+        stats.live_workers = live_count_.load(std::memory_order_relaxed);
+        stats.completed_per_worker.reserve(metrics_.size());
+        for (WorkerMetrics const& metrics : metrics_) {
+            std::uint64_t completed = metrics.completed_.load(std::memory_order_relaxed);
+            stats.completed += completed;
+            stats.completed_per_worker.push_back(completed);
+            stats.queue_wait += metrics.queue_wait_.Snapshot();
+            stats.run_time += metrics.run_time_.Snapshot();
+        }
+        return stats;
     }
 
-    std::size_t Size() const noexcept { return workers_.size(); }
+    // 把第 worker 个常驻线程绑定到 cpus 上; 不支持的平台、失败或线程池已关停时返回 false
+    // NOTE: 持锁访问线程槽位, 可以与 Shutdown/ShutdownNow 并发调用
+    bool SetWorkerAffinity(std::size_t worker, CpuSet const& cpus) noexcept {
+        std::lock_guard lk{mtx_};
+        if (worker >= core_count_ || worker >= workers_.size()) {
+            return false;
+        }
+        return PinThread(workers_[worker], cpus);
+    }
+
+    //--------------------------------------------------------------------------
+    // 协程调度 (Coroutine Scheduling)
+    //--------------------------------------------------------------------------
+
+    // co_await pool.Schedule(): 挂起当前协程, 由某个工作线程恢复
+    class ScheduleAwaiter {
+    public:
+        ScheduleAwaiter(ThreadPool* pool, TaskPriority priority) noexcept
+            : pool_(pool), priority_(priority) {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { pool_->Post(h, priority_); }
+        void await_resume() const noexcept {}
+
+    private:
+        ThreadPool* pool_;
+        TaskPriority priority_;
+    };
+
+    // co_await pool.ScheduleAt(tp): 挂起当前协程, 到期后由工作线程恢复 (不占用任何线程)
+    class TimerAwaiter {
+    public:
+        TimerAwaiter(ThreadPool* pool, std::chrono::steady_clock::time_point deadline) noexcept
+            : pool_(pool), deadline_(deadline) {}
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { pool_->AddTimer(deadline_, h); }
+        void await_resume() const noexcept {}
+
+    private:
+        ThreadPool* pool_;
+        std::chrono::steady_clock::time_point deadline_;
+    };
+
+    [[nodiscard]] ScheduleAwaiter Schedule(
+        TaskPriority priority = TaskPriority::kNormal) noexcept {
+        return ScheduleAwaiter{this, priority};
+    }
+
+    [[nodiscard]] TimerAwaiter ScheduleAt(std::chrono::steady_clock::time_point deadline) noexcept {
+        return TimerAwaiter{this, deadline};
+    }
+
+    template <class Rep, class Period>
+    [[nodiscard]] TimerAwaiter ScheduleAfter(std::chrono::duration<Rep, Period> const& delay) {
+        return ScheduleAt(std::chrono::steady_clock::now() +
+                          std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+    }
 
 private:
-    // 工作线程循环
-    void WorkerLoop() {
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        MoveOnlyFunction<void(std::stop_token const&)> fn_;  // 参数为线程池的 stop_token
+        Clock::time_point enqueued_;                         // 入队时间, 用于老化
+        bool cancellable_;                                   // ShutdownNow 时能否丢弃
+    };
+
+    // 每个优先级一条 FIFO
+    using Lanes = std::array<std::queue<Job>, kTaskPriorityCount>;
+
+    // 把 lanes 中可丢弃的任务移到 dropped, 其余保留原顺序; 返回移走的个数 (需持有锁)
+    static std::size_t DrainCancellable(Lanes& lanes, Lanes& dropped) {
+        std::size_t count = 0;
+        for (std::size_t lane = 0; lane < kTaskPriorityCount; ++lane) {
+            std::queue<Job> kept;
+            while (!lanes[lane].empty()) {
+                Job& job = lanes[lane].front();
+                if (job.cancellable_) {
+                    dropped[lane].push(std::move(job));
+                    ++count;
+                } else {
+                    kept.push(std::move(job));
+                }
+                lanes[lane].pop();
+            }
+            lanes[lane].swap(kept);
+        }
+        return count;
+    }
+
+    // 每个线程槽位独占一组计数器, 按缓存行对齐避免伪共享
+    struct alignas(kCacheLineSize) WorkerMetrics {
+        std::atomic<std::uint64_t> completed_{0};
+        LogHistogram queue_wait_;
+        LogHistogram run_time_;
+    };
+
+    static ThreadPoolOptions DefaultOptions(std::size_t thread_count) {
+        ThreadPoolOptions options;
+        options.thread_count = thread_count;
+        return options;
+    }
+
+    static bool PinThread(std::jthread& thread, CpuSet const& cpus) noexcept {
+        if (cpus.empty()) {
+            return false;
+        }
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                return false;
+            }
+            CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+#else
+        (void)thread;
+        return false;
+#endif
+    }
+
+    // 在槽位 index 上启动工作线程 (需持有锁)
+    // NOTE: 槽位里可能还留着已退出的弹性线程, 挪出来 join (它已不再持有锁, 很快结束)
+    void SpawnWorker(std::size_t index) {
+        std::jthread retired = std::move(workers_[index]);
+        // NOTE: 不使用 jthread 自带的 stop_token: jthread 析构 (Shutdown) 也会请求停止
+        workers_[index] = std::jthread([this, index] {
+            this->WorkerLoop(index);  // 启动工作线程循环
+        });
+        live_[index] = true;
+        live_count_.fetch_add(1, std::memory_order_relaxed);
+        if (!worker_cpus_.empty() &&
+            !PinThread(workers_[index], worker_cpus_[index % worker_cpus_.size()])) {
+            throw std::runtime_error("failed to pin ThreadPool worker");
+        }
+    }
+
+    // 需要时启动一个弹性线程 (需持有锁); 返回是否启动
+    bool MaybeSpawnWorker() {
+        for (std::size_t i = core_count_; i < max_count_; ++i) {
+            if (!live_[i]) {
+                SpawnWorker(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 协程定时器: 按到期时间组成小顶堆
+    struct Timer {
+        std::chrono::steady_clock::time_point deadline_;
+        std::coroutine_handle<> handle_;
+
+        bool operator>(Timer const& other) const noexcept { return deadline_ > other.deadline_; }
+    };
+
+    void Enqueue(TaskOptions const& options, MoveOnlyFunction<void(std::stop_token const&)> fn,
+                 bool cancellable) {
+        auto lane = static_cast<std::size_t>(options.priority);
+        if (lane >= kTaskPriorityCount) {
+            throw std::invalid_argument("invalid TaskPriority");
+        }
+        bool affine = options.worker != TaskOptions::kAnyWorker;
+        if (affine && options.worker >= affine_.size()) {  // 只能指定常驻线程
+            throw std::invalid_argument("TaskOptions::worker out of range");
+        }
+        bool wake;
+        {
+            std::lock_guard lk{mtx_};
+            if (stopping_) {
+                throw std::runtime_error(cancellable
+                                             ? "ThreadPool is stopping; cannot submit."
+                                             : "ThreadPool is stopping; cannot schedule.");
+            }
+            Lanes& lanes = affine ? affine_[options.worker] : lanes_;
+            lanes[lane].push(Job{std::move(fn), Clock::now(), cancellable});
+            pending_.fetch_add(1, std::memory_order_release);
+            ++submitted_;
+            // NOTE: 有线程在自旋就不必唤醒, 它会看到 pending_ 变化;
+            // 没有自旋也没有休眠的线程 (都在忙) 时, 尝试扩容
+            wake = spinning_.load(std::memory_order_relaxed) == 0;
+            if (wake && idle_ == 0 && !affine) {
+                try {
+                    wake = !MaybeSpawnWorker();
+                } catch (...) {  // 扩容失败不影响已入队的任务, 退回到唤醒
+                }
+            }
+        }
+        // NOTE: 所有线程共用一个条件变量, 指定线程的任务只能全部唤醒
+        if (affine) {
+            cv_.notify_all();
+        } else if (wake) {
+            cv_.notify_one();
+        }
+    }
+
+    // 把协程恢复操作作为普通任务入队
+    void Post(std::coroutine_handle<> h, TaskPriority priority) {
+        TaskOptions options;
+        options.priority = priority;
+        Enqueue(options, [h](std::stop_token const&) noexcept { h.resume(); }, false);
+    }
+
+    void AddTimer(std::chrono::steady_clock::time_point deadline, std::coroutine_handle<> h) {
+        bool earliest;
+        {
+            std::lock_guard lk{mtx_};
+            if (stopping_) {
+                throw std::runtime_error("ThreadPool is stopping; cannot schedule.");
+            }
+            earliest = timers_.empty() || deadline < timers_.top().deadline_;
+            timers_.push(Timer{deadline, h});
+            ++submitted_;
+        }
+        // NOTE: 只有新定时器成为最早到期者时, 才需要唤醒一个线程重新计算等待时长
+        if (earliest) {
+            cv_.notify_one();
+        }
+    }
+
+    bool PopFront(std::queue<Job>& queue, Job& out) {
+        if (queue.empty()) {
+            return false;
+        }
+        out = std::move(queue.front());
+        queue.pop();
+        pending_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 为第 worker 个线程选出下一个任务 (需持有锁)
+    bool PopJob(std::size_t worker, Job& out) {
+        Lanes& own = affine_[worker];
+        // 1. 老化: 距上次老化插队已有 aging_interval_ 次出队时, 从最低优先级往上检查,
+        // 队头等待超过阈值的任务先执行
+        // NOTE: 按比例插队而不是一律优先: 低优先级持续积压时队头总是 "已老化",
+        // 一律优先会让高优先级任务反过来被饿死
+        // NOTE: 只有低优先级队列非空时才读时钟
+        if (++pops_since_aged_ >= aging_interval_) {
+            Clock::time_point now{};
+            for (std::size_t lane = kTaskPriorityCount - 1; lane > 0; --lane) {
+                for (std::queue<Job>* queue : {&own[lane], &lanes_[lane]}) {
+                    if (queue->empty()) {
+                        continue;
+                    }
+                    if (now == Clock::time_point{}) {
+                        now = Clock::now();
+                    }
+                    if (now - queue->front().enqueued_ >= aging_) {
+                        pops_since_aged_ = 0;
+                        return PopFront(*queue, out);
+                    }
+                }
+            }
+        }
+        // 2. 按优先级从高到低, 同一优先级先取指定给本线程的任务
+        for (std::size_t lane = 0; lane < kTaskPriorityCount; ++lane) {
+            if (PopFront(own[lane], out) || PopFront(lanes_[lane], out)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 取出一个可执行的任务: 到期的协程定时器优先, 其次是任务队列 (需持有锁)
+    bool TakeJob(std::size_t index, Job& job) {
+        // 停止时不再等待定时器, 立即恢复让协程收尾
+        if (!timers_.empty() && (stopping_ || timers_.top().deadline_ <= Clock::now())) {
+            Timer const& timer = timers_.top();
+            std::coroutine_handle<> h = timer.handle_;
+            // 从到期时刻起算排队等待时间
+            job = Job{[h](std::stop_token const&) noexcept { h.resume(); }, timer.deadline_, false};
+            timers_.pop();
+            return true;
+        }
+        return PopJob(index, job);
+    }
+
+    // 锁外自旋等待新任务; 返回 true 表示看到了新任务
+    bool SpinForJob() const noexcept {
+        Backoff backoff{spin_limit_};
+        while (pending_.load(std::memory_order_acquire) == 0) {
+            if (!backoff.Pause()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 取下一个任务; 返回 false 表示本线程应退出
+    bool NextJob(std::size_t index, Job& job) {
+        std::unique_lock lk{mtx_};
+        bool spun = false;
         while (true) {
-            std::function<void()> job;  // 任务
-            {
-                std::unique_lock lk{mtx_};
-                // 等到有任务，或线程池进入停止状态。
-                cv_.wait(lk, [this] { return stopping_ || !tasks_.empty(); });
-                if (stopping_ && tasks_.empty()) {  // 停止且队列空，安全退出
-                    return;                         // NOTE: 工作线程会消费完所有任务, 然后退出
+            if (TakeJob(index, job)) {
+                // NOTE: 有线程在自旋时 Enqueue 不唤醒休眠线程; 取走任务后还有剩余且没人在自旋,
+                // 就接力唤醒一个休眠线程 (与 Go 调度器相同), 否则一批任务会由自旋线程串行执行
+                bool relay = idle_ > 0 && pending_.load(std::memory_order_relaxed) > 0 &&
+                             spinning_.load(std::memory_order_relaxed) == 0;
+                lk.unlock();
+                if (relay) {
+                    cv_.notify_one();
                 }
-                job = std::move(tasks_.front());  // 从队列中取出任务
-                tasks_.pop();
+                return true;
+            }
+            if (stopping_) {  // 停止且队列空，安全退出
+                return false;  // NOTE: 工作线程会消费完所有任务, 然后退出
+            }
+            // 1. 先自旋: 任务往往很快到来, 自旋能省掉一次休眠/唤醒的 futex 系统调用
+            if (!spun && spin_limit_ > 0) {
+                spun = true;
+                spinning_.fetch_add(1, std::memory_order_relaxed);
+                lk.unlock();
+                SpinForJob();
+                lk.lock();
+                // NOTE: 在锁内撤销自旋标记, 随后在锁内重新检查队列, 保证不会丢失唤醒
+                spinning_.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            // 2. 再休眠: 等到有任务，或最早的定时器到期，或线程池进入停止状态。
+            bool elastic = index >= core_count_;
+            bool timed_out = false;
+            ++idle_;
+            if (!timers_.empty()) {
+                cv_.wait_until(lk, timers_.top().deadline_);
+            } else if (elastic) {
+                timed_out = cv_.wait_for(lk, idle_timeout_) == std::cv_status::timeout;
+            } else {
+                cv_.wait(lk);
             }
+            --idle_;
+            spun = false;
+            // 3. 弹性线程空闲超时后退出, 槽位留给之后扩容复用
+            if (timed_out && !stopping_ && pending_.load(std::memory_order_relaxed) == 0) {
+                live_[index] = false;
+                live_count_.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+    }
+
+    static std::uint64_t Nanoseconds(Clock::duration d) noexcept {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+        return ns > 0 ? static_cast<std::uint64_t>(ns) : 0;
+    }
+
+    // 工作线程循环
+    void WorkerLoop(std::size_t index) {
+        std::stop_token st = shutdown_now_.get_token();  // 传给任务的令牌
+        WorkerMetrics& metrics = metrics_[index];
+        Job job;  // 任务
+        while (NextJob(index, job)) {
             // NOTE: 在锁外执行任务，避免阻塞生产者或其他工作线程。
-            job();
+            if (collect_latency_) {
+                Clock::time_point start = Clock::now();
+                job.fn_(st);
+                Clock::time_point finish = Clock::now();
+                metrics.queue_wait_.Record(Nanoseconds(start - job.enqueued_));
+                metrics.run_time_.Record(Nanoseconds(finish - start));
+            } else {
+                job.fn_(st);
+            }
+            job.fn_ = nullptr;  // 尽早释放任务捕获的资源
+            // NOTE: 单写者计数, 不需要 fetch_add
+            metrics.completed_.store(metrics.completed_.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
         }
     }
 
+    std::size_t core_count_;                   // 常驻线程数
+    std::size_t max_count_;                    // 最多线程数
+    Clock::duration idle_timeout_;             // 弹性线程空闲超时
+    std::uint32_t spin_limit_;                 // 休眠前自旋退避步数
+    Clock::duration aging_;                    // 老化阈值
+    std::uint32_t aging_interval_;             // 老化插队的最小出队间隔
+    std::vector<CpuSet> worker_cpus_;          // CPU 绑定配置
+    bool collect_latency_;                     // 是否统计耗时
+    std::vector<WorkerMetrics> metrics_;       // 每个线程槽位的度量
+
     mutable std::mutex mtx_;                   // 互斥锁
     std::condition_variable cv_;               // 条件变量
-    std::vector<std::jthread> workers_;        // 工作线程 (C++20 jthread)
-    std::queue<std::function<void()>> tasks_;  // 任务队列
+    std::vector<std::jthread> workers_;        // 工作线程槽位 (C++20 jthread)
+    Lanes lanes_;                              // 共享任务队列 (按优先级分道)
+    std::vector<Lanes> affine_;                // 指定了工作线程的任务队列
+    std::vector<bool> live_;                   // 槽位上的线程是否存活
+    std::size_t idle_{0};                      // 正在休眠的线程数
+    std::atomic<std::size_t> pending_{0};      // 排队中的任务数 (供自旋线程无锁观察)
+    std::atomic<std::size_t> spinning_{0};     // 正在自旋的线程数
+    std::atomic<std::size_t> live_count_{0};   // 存活线程数
+    std::uint64_t submitted_{0};               // 已提交任务数 (受 mtx_ 保护)
+    std::uint32_t pops_since_aged_{0};         // 距上次老化插队的出队次数 (受 mtx_ 保护)
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;  // 协程定时器
+    std::stop_source shutdown_now_;            // ShutdownNow 时触发, 任务经 stop_token 观察
     bool stopping_;                            // 停止标志
 };
 }  // namespace cutestl
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <memory>
+
+// 生态位 (niche) 定制点: 类型有一个正常情况下永远不会出现的哨兵值时,
+// Optional 用它表示 "空", 省掉单独的 bool 和对齐填充, 例如 sizeof(Optional<T*>) == sizeof(T*)
+//
+// 特化 NicheTraits<T> 并提供:
+//   static void SetEmpty(T* storage) noexcept;       // 在未初始化的 storage 上构造哨兵
+//   static bool IsEmpty(T const& value) noexcept;    // value 是否为哨兵
+//
+// NOTE: 哨兵对象不会被析构, 而是直接被新值覆盖, 所以哨兵不能持有任何资源
+// NOTE: 哨兵值本身不能再作为有效值存入 Optional, 否则会被当成空
+
+namespace cutestl {
+
+// 主模板: 没有可用的哨兵值
+template <typename T>
+struct NicheTraits {};
+
+template <typename T>
+concept _HasNiche = requires(T* storage, T const& value) {
+    { NicheTraits<T>::SetEmpty(storage) } noexcept;
+    { NicheTraits<T>::IsEmpty(value) } noexcept -> std::same_as<bool>;
+};
+
+// 指针的哨兵: 地址空间最高处, 用户态永远不可能有对象在这里 (且对大多数类型是未对齐的)
+// NOTE: 与 nullptr 不同, Optional<T*>{nullptr} 仍然是有值的
+template <typename P>
+P _NichePointer() noexcept {
+    return reinterpret_cast<P>(~std::uintptr_t{0});
+}
+
+template <typename T>
+struct NicheTraits<T*> {
+    static void SetEmpty(T** storage) noexcept { std::construct_at(storage, _NichePointer<T*>()); }
+
+    static bool IsEmpty(T* const& value) noexcept { return value == _NichePointer<T*>(); }
+};
+
+}  // namespace cutestl
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "vector.hpp"
+
+// 优先队列 (二叉堆), 语义同 std::priority_queue: 默认 std::less 时 Top() 是最大的元素
+// NOTE: 上浮/下沉用 "空穴" 法: 先把元素移出, 沿路径把父/子元素搬进空穴, 最后放回一次,
+// 每层一次移动而不是一次交换 (三次移动)
+
+namespace cutestl {
+
+template <typename T, typename Compare = std::less<T>, typename Container = Vector<T>>
+class PriorityQueue {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using value_compare = Compare;
+    using container_type = Container;
+    using reference = T&;
+    using const_reference = T const&;
+
+public:
+    PriorityQueue() = default;
+
+    explicit PriorityQueue(Compare const& comp) : comp_(comp) {}
+
+    // 整体建堆 (Floyd), O(n), 比逐个 Push 的 O(n log n) 快
+    template <std::input_iterator InputIt>
+    PriorityQueue(InputIt first, InputIt last, Compare const& comp = Compare()) : comp_(comp) {
+        for (; first != last; ++first) {
+            heap_.PushBack(T(*first));
+        }
+        MakeHeap();
+    }
+
+    PriorityQueue(std::initializer_list<T> init, Compare const& comp = Compare())
+        : PriorityQueue(init.begin(), init.end(), comp) {}
+
+public:
+    const_reference Top() const {
+        assert(!Empty());
+        return heap_[0];
+    }
+
+    bool Empty() const { return heap_.Empty(); }
+
+    size_type Size() const { return heap_.Size(); }
+
+    void Push(T const& value) { Emplace(value); }
+
+    void Push(T&& value) { Emplace(std::move(value)); }
+
+    template <typename... Args>
+    void Emplace(Args&&... args) {
+        heap_.PushBack(T(std::forward<Args>(args)...));
+        SiftUp(Size() - 1);
+    }
+
+    void Pop() {
+        assert(!Empty());
+        if (Size() > 1) {
+            T last{std::move(heap_.Back())};
+            heap_.PopBack();
+            SiftDown(0, std::move(last));
+        } else {
+            heap_.PopBack();
+        }
+    }
+
+    // 取出堆顶 (Top + Pop, 移动而不是拷贝)
+    T Take() {
+        assert(!Empty());
+        T top{std::move(heap_[0])};
+        Pop();
+        return top;
+    }
+
+    void Clear() { heap_.Clear(); }
+
+    // 只读访问底层数组 (堆序, 不是有序)
+    Container const& Data() const noexcept { return heap_; }
+
+private:
+    static size_type Parent(size_type i) noexcept { return (i - 1) / 2; }
+
+    void MakeHeap() {
+        for (size_type i = Size() / 2; i-- > 0;) {
+            T value{std::move(heap_[i])};
+            SiftDown(i, std::move(value));
+        }
+    }
+
+    void SiftUp(size_type hole) {
+        T value{std::move(heap_[hole])};
+        while (hole > 0 && comp_(heap_[Parent(hole)], value)) {
+            heap_[hole] = std::move(heap_[Parent(hole)]);
+            hole = Parent(hole);
+        }
+        heap_[hole] = std::move(value);
+    }
+
+    // hole 处的元素已被移出, 把 value 放到 hole 以下的合适位置
+    void SiftDown(size_type hole, T&& value) {
+        size_type size = Size();
+        for (size_type child = 2 * hole + 1; child < size; child = 2 * hole + 1) {
+            if (child + 1 < size && comp_(heap_[child], heap_[child + 1])) {
+                ++child;
+            }
+            if (!comp_(value, heap_[child])) {
+                break;
+            }
+            heap_[hole] = std::move(heap_[child]);
+            hole = child;
+        }
+        heap_[hole] = std::move(value);
+    }
+
+    Container heap_;
+    [[no_unique_address]] Compare comp_;
+};
+
+}  // namespace cutestl
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "_bit_ops.hpp"
+#include "vector.hpp"
+
+// 位集上的 rank / select 辅助索引
+// - Rank(pos): [0, pos) 中 1 的个数, O(1)
+// - Select(k): 第 k 个 (从 0 数) 1 的位置, 采样缩小范围后二分, 近似 O(1)
+// 用法 (把选中行的序号映射回行号, 或反过来):
+//   RankSelect index{selected.Words()};
+//   std::size_t nth = index.Rank(row);   // row 是第几个被选中的行
+//   std::size_t row = index.Select(nth);
+//
+// NOTE: 每 512 位 (8 个字, 一条缓存行) 一个块, 记录块之前 1 的累计个数, 额外空间 1/8;
+// Rank 只需一次查表加块内至多 8 次 popcount
+// NOTE: 每 4096 个 1 记录一次它所在的块, Select 只在两个采样点之间二分
+// NOTE: 索引引用位集的字数组但不拥有它; 位集修改或重新分配后要重新构建
+
+namespace cutestl {
+
+class RankSelect {
+public:
+    using size_type = std::size_t;
+    using word_type = std::uint64_t;
+
+public:
+    RankSelect() = default;
+
+    explicit RankSelect(std::span<word_type const> words) : words_(words) {
+        size_type blocks = (words_.size() + kBlockWords - 1) / kBlockWords;
+        block_rank_.Reserve(blocks + 1);
+        size_type ones = 0;
+        for (size_type b = 0; b < blocks; ++b) {
+            block_rank_.PushBack(ones);
+            size_type first = b * kBlockWords;
+            size_type count = std::min(kBlockWords, words_.size() - first);
+            ones += _PopcountWords(words_.data() + first, count);
+            // 第 samples_.Size() * kSelectSample 个 1 落在这个块里
+            while (samples_.Size() * kSelectSample < ones) {
+                samples_.PushBack(b);
+            }
+        }
+        block_rank_.PushBack(ones);
+    }
+
+public:
+    // 1 的总数
+    size_type Ones() const noexcept { return block_rank_.Empty() ? 0 : block_rank_.Back(); }
+
+    // [0, pos) 中 1 的个数; pos 不超过字数组的总位数
+    size_type Rank(size_type pos) const noexcept {
+        assert(pos <= words_.size() * _kWordBits);
+        size_type word = pos / _kWordBits;
+        size_type block = word / kBlockWords;
+        if (block_rank_.Empty()) {
+            return 0;
+        }
+        size_type rank = block_rank_[block];
+        rank += _PopcountWords(words_.data() + block * kBlockWords, word - block * kBlockWords);
+        if (pos % _kWordBits != 0) {
+            rank += std::popcount(words_[word] & _TailMask(pos));
+        }
+        return rank;
+    }
+
+    // 第 k 个 (从 0 数) 1 的位置; k >= Ones() 时返回总位数
+    size_type Select(size_type k) const noexcept {
+        if (k >= Ones()) {
+            return words_.size() * _kWordBits;
+        }
+        // 答案所在的块介于两个相邻采样点之间
+        size_type sample = k / kSelectSample;
+        size_type lo = samples_[sample];
+        size_type hi = sample + 1 < samples_.Size() ? samples_[sample + 1] + 1
+                                                    : block_rank_.Size() - 1;
+        // 最后一个累计个数 <= k 的块
+        size_type block =
+            std::upper_bound(block_rank_.begin() + lo, block_rank_.begin() + hi, k) -
+            block_rank_.begin() - 1;
+        size_type rest = k - block_rank_[block];
+        for (size_type i = block * kBlockWords;; ++i) {
+            auto count = static_cast<size_type>(std::popcount(words_[i]));
+            if (rest < count) {
+                return i * _kWordBits + _SelectInWord(words_[i], static_cast<unsigned>(rest));
+            }
+            rest -= count;
+        }
+    }
+
+private:
+    static constexpr size_type kBlockWords = 8;
+    static constexpr size_type kSelectSample = 4096;
+
+    std::span<word_type const> words_;
+    Vector<size_type> block_rank_;  // block_rank_[b]: 第 b 块之前 1 的个数, 末尾多一项总数
+    Vector<size_type> samples_;     // samples_[j]: 第 j * kSelectSample 个 1 所在的块
+};
+
+}  // namespace cutestl
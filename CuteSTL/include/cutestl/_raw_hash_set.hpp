@@ -0,0 +1,714 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) && !defined(CUTESTL_NO_SIMD)
+#include <emmintrin.h>
+#define CUTESTL_HASH_SSE2 1
+#endif
+
+#include "_hash.hpp"
+#include "_key_arg.hpp"
+
+// 开放寻址哈希表 (SwissTable), FlatHashMap 与 FlatHashSet 的公共实现
+//
+// NOTE: 内存布局
+// - 元素直接放在连续的槽位数组 slots_ 里, 没有逐元素的节点分配
+// - 每个槽位对应一个控制字节 ctrl_[i]: 空 / 已删除 (墓碑) / 满, 满时低 7 位存哈希的 H2 部分
+// - capacity_ 总是 2^k - 1, ctrl_[capacity_] 是哨兵 (迭代到这里结束),
+//   其后再复制前 kWidth - 1 个控制字节, 这样从任意位置读一整组都不用处理回绕
+//
+// NOTE: 查找
+// - 哈希的高位 H1 决定从哪一组开始探测, 组间按三角数序列跳跃
+// - 一次 SIMD 比较一组 16 个控制字节与 H2, 只有 H2 相同 (约 1/128 的误报) 的槽位才比较键
+// - 组里有空字节即可断定键不存在, 所以未命中的查找通常也只读一组控制字节
+//
+// NOTE: 哈希函数与元素的移动构造不应抛异常 (扩容时逐个搬移元素)
+
+namespace cutestl {
+
+using _CtrlByte = std::int8_t;
+
+inline constexpr _CtrlByte _kCtrlEmpty = -128;   // 0b10000000
+inline constexpr _CtrlByte _kCtrlDeleted = -2;   // 0b11111110
+inline constexpr _CtrlByte _kCtrlSentinel = -1;  // 0b11111111
+
+constexpr bool _IsFull(_CtrlByte ctrl) noexcept { return ctrl >= 0; }
+
+// 组内匹配结果: 每个匹配的控制字节对应一位, kShift 把位下标换算成字节下标
+template <typename T, int kShift>
+class _BitMask {
+public:
+    explicit _BitMask(T mask) noexcept : mask_(mask) {}
+
+    explicit operator bool() const noexcept { return mask_ != 0; }
+
+    std::uint32_t LowestBitSet() const noexcept { return std::countr_zero(mask_) >> kShift; }
+
+    // 最低位之前 / 最高位之后连续的 0 对应多少字节
+    std::uint32_t TrailingZeros() const noexcept { return std::countr_zero(mask_) >> kShift; }
+    std::uint32_t LeadingZeros() const noexcept { return std::countl_zero(mask_) >> kShift; }
+
+    // 支持 for (std::uint32_t i : group.Match(h2))
+    _BitMask begin() const noexcept { return *this; }
+    _BitMask end() const noexcept { return _BitMask{0}; }
+    std::uint32_t operator*() const noexcept { return LowestBitSet(); }
+    _BitMask& operator++() noexcept {
+        mask_ &= mask_ - 1;
+        return *this;
+    }
+    bool operator==(_BitMask const&) const noexcept = default;
+
+private:
+    T mask_;
+};
+
+#if defined(CUTESTL_HASH_SSE2)
+
+// 一组 16 个控制字节, 用 SSE2 一次比较
+class _Group {
+public:
+    static constexpr std::size_t kWidth = 16;
+
+    explicit _Group(_CtrlByte const* pos) noexcept
+        : ctrl_(_mm_loadu_si128(reinterpret_cast<__m128i const*>(pos))) {}
+
+    _BitMask<std::uint16_t, 0> Match(_CtrlByte h2) const noexcept {
+        return ToMask(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_));
+    }
+
+    _BitMask<std::uint16_t, 0> MaskEmpty() const noexcept {
+        return ToMask(_mm_cmpeq_epi8(_mm_set1_epi8(_kCtrlEmpty), ctrl_));
+    }
+
+    // 空或墓碑: 有符号比较小于哨兵 (-1) 的字节
+    _BitMask<std::uint16_t, 0> MaskEmptyOrDeleted() const noexcept {
+        return ToMask(_mm_cmpgt_epi8(_mm_set1_epi8(_kCtrlSentinel), ctrl_));
+    }
+
+private:
+    static _BitMask<std::uint16_t, 0> ToMask(__m128i bytes) noexcept {
+        return _BitMask<std::uint16_t, 0>{static_cast<std::uint16_t>(_mm_movemask_epi8(bytes))};
+    }
+
+    __m128i ctrl_;
+};
+
+#else
+
+// 没有 SSE2 时的可移植实现: 一组 8 个控制字节装进一个 uint64_t, 用位运算并行比较 (SWAR)
+// 匹配结果放在每个字节的最高位, 所以 kShift = 3
+class _Group {
+    static_assert(std::endian::native == std::endian::little, "可移植实现假定小端序");
+
+public:
+    static constexpr std::size_t kWidth = 8;
+
+    explicit _Group(_CtrlByte const* pos) noexcept { std::memcpy(&ctrl_, pos, sizeof(ctrl_)); }
+
+    // NOTE: 可能有误报, 但只会落在满槽位上 (空/墓碑/哨兵的最高位为 1, 不会被选中), 调用方会再比较键
+    _BitMask<std::uint64_t, 3> Match(_CtrlByte h2) const noexcept {
+        std::uint64_t x = ctrl_ ^ (kLsbs * static_cast<std::uint8_t>(h2));
+        return _BitMask<std::uint64_t, 3>{(x - kLsbs) & ~x & kMsbs};
+    }
+
+    // 空: 最高位为 1 且第 1 位为 0
+    _BitMask<std::uint64_t, 3> MaskEmpty() const noexcept {
+        return _BitMask<std::uint64_t, 3>{ctrl_ & ~(ctrl_ << 6) & kMsbs};
+    }
+
+    // 空或墓碑: 最高位为 1 且第 0 位为 0
+    _BitMask<std::uint64_t, 3> MaskEmptyOrDeleted() const noexcept {
+        return _BitMask<std::uint64_t, 3>{ctrl_ & ~(ctrl_ << 7) & kMsbs};
+    }
+
+private:
+    static constexpr std::uint64_t kLsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t kMsbs = 0x8080808080808080ULL;
+
+    std::uint64_t ctrl_;
+};
+
+#endif
+
+// 空表共用的一组控制字节: 哨兵 + 空, 这样空表的查找与迭代不需要特判, 也不需要分配
+alignas(16) inline constexpr _CtrlByte _kEmptyGroup[16] = {
+    _kCtrlSentinel, _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty,
+    _kCtrlEmpty,    _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty,
+    _kCtrlEmpty,    _kCtrlEmpty, _kCtrlEmpty, _kCtrlEmpty};
+
+// 按组探测: 第 i 次跳 i * kWidth 个位置 (三角数序列), 容量为 2^k - 1 时能遍历所有组
+class _ProbeSeq {
+public:
+    _ProbeSeq(std::size_t hash, std::size_t mask) noexcept : mask_(mask), offset_(hash & mask) {}
+
+    std::size_t Offset() const noexcept { return offset_; }
+    std::size_t Offset(std::size_t i) const noexcept { return (offset_ + i) & mask_; }
+
+    void Next() noexcept {
+        index_ += _Group::kWidth;
+        offset_ = (offset_ + index_) & mask_;
+    }
+
+private:
+    std::size_t mask_;
+    std::size_t offset_;
+    std::size_t index_{0};
+};
+
+template <typename Policy, bool kConst>
+class _RawHashIterator {
+    template <typename P, bool C>
+    friend class _RawHashIterator;
+
+    template <typename P, typename H, typename E, typename A>
+    friend class _RawHashSet;
+
+    using Slot = typename Policy::Slot;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Policy::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<kConst, value_type const&,
+                                         decltype(Policy::Element(std::declval<Slot*>()))>;
+    using pointer = std::remove_reference_t<reference>*;
+
+    _RawHashIterator() noexcept = default;
+    _RawHashIterator(_RawHashIterator const&) noexcept = default;
+    _RawHashIterator& operator=(_RawHashIterator const&) noexcept = default;
+
+    // iterator 可以隐式转换为 const_iterator
+    _RawHashIterator(_RawHashIterator<Policy, false> const& other) noexcept
+        requires kConst
+        : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+    reference operator*() const noexcept { return Policy::Element(slot_); }
+
+    pointer operator->() const noexcept { return std::addressof(**this); }
+
+    _RawHashIterator& operator++() noexcept {
+        ++ctrl_;
+        ++slot_;
+        SkipEmptyOrDeleted();
+        return *this;
+    }
+
+    _RawHashIterator operator++(int) noexcept {
+        _RawHashIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    bool operator==(_RawHashIterator const& other) const noexcept { return ctrl_ == other.ctrl_; }
+
+private:
+    _RawHashIterator(_CtrlByte* ctrl, Slot* slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+    // 跳过空位与墓碑, 停在满槽位或哨兵上
+    void SkipEmptyOrDeleted() noexcept {
+        while (*ctrl_ < _kCtrlSentinel) {
+            ++ctrl_;
+            ++slot_;
+        }
+    }
+
+    _CtrlByte* ctrl_{nullptr};
+    Slot* slot_{nullptr};
+};
+
+// Policy 描述槽位里存什么:
+//   Slot, key_type, value_type
+//   Element(Slot*) -> 元素引用, Key(Slot*) -> 键, KeyOf(value_type const&) -> 键
+//   Construct(Slot*, args...), Destroy(Slot*), Transfer(Slot* to, Slot* from)
+template <typename Policy, typename Hash, typename Eq, typename Alloc>
+class _RawHashSet {
+protected:
+    using Slot = typename Policy::Slot;
+    using CtrlAllocator = typename Alloc::template rebind<_CtrlByte>::other;
+    using SlotAllocator = typename Alloc::template rebind<Slot>::other;
+
+    static constexpr bool kTransparent =
+        requires { typename Hash::is_transparent; typename Eq::is_transparent; };
+
+public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using iterator = _RawHashIterator<Policy, false>;
+    using const_iterator = _RawHashIterator<Policy, true>;
+
+protected:
+    template <typename Q>
+    using KeyArg = typename _KeyArg<kTransparent>::template type<Q, key_type>;
+
+public:
+    _RawHashSet() noexcept(std::is_nothrow_default_constructible_v<Hash> &&
+                           std::is_nothrow_default_constructible_v<Eq> &&
+                           std::is_nothrow_default_constructible_v<Alloc>) = default;
+
+    explicit _RawHashSet(size_type bucket_count, Hash const& hash = Hash(), Eq const& eq = Eq(),
+                         Alloc const& alloc = Alloc())
+        : hash_(hash), eq_(eq), alloc_(alloc) {
+        Reserve(bucket_count);
+    }
+
+    explicit _RawHashSet(Alloc const& alloc) : alloc_(alloc) {}
+
+    template <std::input_iterator InputIt>
+    _RawHashSet(InputIt first, InputIt last, size_type bucket_count = 0, Hash const& hash = Hash(),
+                Eq const& eq = Eq(), Alloc const& alloc = Alloc())
+        : _RawHashSet(bucket_count, hash, eq, alloc) {
+        Insert(first, last);
+    }
+
+    _RawHashSet(std::initializer_list<value_type> init, size_type bucket_count = 0,
+                Hash const& hash = Hash(), Eq const& eq = Eq(), Alloc const& alloc = Alloc())
+        : _RawHashSet(init.begin(), init.end(), bucket_count, hash, eq, alloc) {}
+
+    _RawHashSet(_RawHashSet const& other)
+        : hash_(other.hash_), eq_(other.eq_), alloc_(other.alloc_) {
+        Reserve(other.size_);
+        try {
+            // NOTE: 源表里没有重复键, 直接找空位插入, 不需要比较键
+            for (const_iterator it = other.begin(); it != other.end(); ++it) {
+                std::size_t hash = HashOf(Policy::Key(it.slot_));
+                std::size_t index = PrepareInsert(hash);
+                EmplaceAt(index, *it);
+            }
+        } catch (...) {
+            DestroyAndDeallocate();
+            throw;
+        }
+    }
+
+    _RawHashSet(_RawHashSet&& other) noexcept
+        : ctrl_(std::exchange(other.ctrl_, EmptyGroup())),
+          slots_(std::exchange(other.slots_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          growth_left_(std::exchange(other.growth_left_, 0)),
+          hash_(other.hash_),
+          eq_(other.eq_),
+          alloc_(other.alloc_) {}
+
+    // copy-and-swap
+    _RawHashSet& operator=(_RawHashSet const& other) {
+        if (this != &other) {
+            _RawHashSet tmp{other};
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    _RawHashSet& operator=(_RawHashSet&& other) noexcept {
+        _RawHashSet tmp{std::move(other)};
+        Swap(tmp);
+        return *this;
+    }
+
+    _RawHashSet& operator=(std::initializer_list<value_type> init) {
+        Clear();
+        Insert(init);
+        return *this;
+    }
+
+    ~_RawHashSet() { DestroyAndDeallocate(); }
+
+    //--------------------------------------------------------------------------
+    // 迭代器
+    //--------------------------------------------------------------------------
+
+    iterator begin() noexcept {
+        iterator it{ctrl_, slots_};
+        it.SkipEmptyOrDeleted();
+        return it;
+    }
+    const_iterator begin() const noexcept { return const_cast<_RawHashSet*>(this)->begin(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator{ctrl_ + capacity_, slots_ + capacity_}; }
+    const_iterator end() const noexcept { return const_cast<_RawHashSet*>(this)->end(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    //--------------------------------------------------------------------------
+    // 容量
+    //--------------------------------------------------------------------------
+
+    bool Empty() const noexcept { return size_ == 0; }
+
+    size_type Size() const noexcept { return size_; }
+
+    // 槽位总数; 最多能放 7/8 的槽位
+    size_type Capacity() const noexcept { return capacity_; }
+
+    float LoadFactor() const noexcept {
+        return capacity_ ? static_cast<float>(size_) / static_cast<float>(capacity_) : 0.0f;
+    }
+
+    // 保证再插入到 n 个元素之前不会扩容
+    void Reserve(size_type n) {
+        if (n > size_ + growth_left_) {
+            Resize(NormalizeCapacity(GrowthToLowerboundCapacity(n)));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // 查找
+    //--------------------------------------------------------------------------
+
+    template <typename Q = key_type>
+    iterator Find(KeyArg<Q> const& key) {
+        return IteratorAt(FindIndex(key, HashOf(key)));
+    }
+
+    template <typename Q = key_type>
+    const_iterator Find(KeyArg<Q> const& key) const {
+        return const_cast<_RawHashSet*>(this)->Find(key);
+    }
+
+    template <typename Q = key_type>
+    bool Contains(KeyArg<Q> const& key) const {
+        return FindIndex(key, HashOf(key)) != capacity_;
+    }
+
+    template <typename Q = key_type>
+    size_type Count(KeyArg<Q> const& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    //--------------------------------------------------------------------------
+    // 修改器
+    //--------------------------------------------------------------------------
+
+    std::pair<iterator, bool> Insert(value_type const& value) { return InsertImpl(value); }
+
+    std::pair<iterator, bool> Insert(value_type&& value) { return InsertImpl(std::move(value)); }
+
+    template <std::input_iterator InputIt>
+    void Insert(InputIt first, InputIt last) {
+        if constexpr (std::forward_iterator<InputIt>) {
+            Reserve(size_ + static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            Emplace(*first);
+        }
+    }
+
+    void Insert(std::initializer_list<value_type> init) { Insert(init.begin(), init.end()); }
+
+    // 先在临时槽位里构造元素拿到键, 键不存在时再搬进表里
+    template <typename... Args>
+    std::pair<iterator, bool> Emplace(Args&&... args) {
+        alignas(Slot) unsigned char buffer[sizeof(Slot)];
+        Slot* tmp = reinterpret_cast<Slot*>(buffer);
+        Policy::Construct(tmp, std::forward<Args>(args)...);
+        std::pair<std::size_t, bool> result;
+        try {
+            result = FindOrPrepareInsert(Policy::Key(tmp));
+        } catch (...) {
+            Policy::Destroy(tmp);
+            throw;
+        }
+        if (result.second) {
+            Policy::Transfer(slots_ + result.first, tmp);
+        } else {
+            Policy::Destroy(tmp);
+        }
+        return {IteratorAt(result.first), result.second};
+    }
+
+    // 返回被删除元素之后的迭代器
+    iterator Erase(const_iterator pos) noexcept {
+        std::size_t index = static_cast<std::size_t>(pos.ctrl_ - ctrl_);
+        Policy::Destroy(slots_ + index);
+        EraseMetaOnly(index);
+        iterator next{ctrl_ + index, slots_ + index};
+        next.SkipEmptyOrDeleted();
+        return next;
+    }
+
+    iterator Erase(iterator pos) noexcept { return Erase(const_iterator{pos}); }
+
+    template <typename Q = key_type>
+    size_type Erase(KeyArg<Q> const& key) {
+        std::size_t index = FindIndex(key, HashOf(key));
+        if (index == capacity_) {
+            return 0;
+        }
+        Policy::Destroy(slots_ + index);
+        EraseMetaOnly(index);
+        return 1;
+    }
+
+    // 销毁所有元素, 保留容量
+    void Clear() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        DestroySlots();
+        ResetCtrl();
+        size_ = 0;
+        growth_left_ = CapacityToGrowth(capacity_);
+    }
+
+    void Swap(_RawHashSet& other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(size_, other.size_);
+        swap(capacity_, other.capacity_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+        swap(alloc_, other.alloc_);
+    }
+
+    //--------------------------------------------------------------------------
+    // 观察器
+    //--------------------------------------------------------------------------
+
+    hasher HashFunction() const { return hash_; }
+
+    key_equal KeyEq() const { return eq_; }
+
+    allocator_type GetAllocator() const { return alloc_; }
+
+protected:
+    template <typename Q>
+    std::size_t HashOf(Q const& key) const {
+        return _MixHash(hash_(key));
+    }
+
+    static std::size_t H1(std::size_t hash) noexcept { return hash >> 7; }
+
+    static _CtrlByte H2(std::size_t hash) noexcept { return static_cast<_CtrlByte>(hash & 0x7F); }
+
+    iterator IteratorAt(std::size_t index) noexcept {
+        return iterator{ctrl_ + index, slots_ + index};
+    }
+
+    // 找到时返回槽位下标, 否则返回 capacity_
+    template <typename Q>
+    std::size_t FindIndex(Q const& key, std::size_t hash) const {
+        _ProbeSeq seq{H1(hash), capacity_};
+        while (true) {
+            _Group group{ctrl_ + seq.Offset()};
+            for (std::uint32_t i : group.Match(H2(hash))) {
+                std::size_t index = seq.Offset(i);
+                if (eq_(Policy::Key(slots_ + index), key)) [[likely]] {
+                    return index;
+                }
+            }
+            if (group.MaskEmpty()) [[likely]] {
+                return capacity_;
+            }
+            seq.Next();
+        }
+    }
+
+    // 返回 {槽位下标, 是否需要在该槽位构造新元素}
+    template <typename Q>
+    std::pair<std::size_t, bool> FindOrPrepareInsert(Q const& key) {
+        std::size_t hash = HashOf(key);
+        std::size_t index = FindIndex(key, hash);
+        if (index != capacity_) {
+            return {index, false};
+        }
+        return {PrepareInsert(hash), true};
+    }
+
+    // 在已由 PrepareInsert 占下的槽位上构造元素; 构造失败时把槽位还回去
+    template <typename... Args>
+    void EmplaceAt(std::size_t index, Args&&... args) {
+        try {
+            Policy::Construct(slots_ + index, std::forward<Args>(args)...);
+        } catch (...) {
+            EraseMetaOnly(index);
+            throw;
+        }
+    }
+
+private:
+    static constexpr std::size_t kClonedBytes = _Group::kWidth - 1;
+
+    static _CtrlByte* EmptyGroup() noexcept { return const_cast<_CtrlByte*>(_kEmptyGroup); }
+
+    // 2^k - 1 形式的容量
+    static std::size_t NormalizeCapacity(std::size_t n) noexcept {
+        return n ? ~std::size_t{0} >> std::countl_zero(n) : 1;
+    }
+
+    // 最大装载因子 7/8; 容量为 7 时只放 6 个, 保证可移植实现 (每组 8 字节) 的组里总有空位
+    static std::size_t CapacityToGrowth(std::size_t capacity) noexcept {
+        return capacity == 7 ? 6 : capacity - capacity / 8;
+    }
+
+    static std::size_t GrowthToLowerboundCapacity(std::size_t growth) noexcept {
+        return growth == 7 ? 8 : growth + (growth - 1) / 7;
+    }
+
+    template <typename V>
+    std::pair<iterator, bool> InsertImpl(V&& value) {
+        auto [index, inserted] = FindOrPrepareInsert(Policy::KeyOf(value));
+        if (inserted) {
+            EmplaceAt(index, std::forward<V>(value));
+        }
+        return {IteratorAt(index), inserted};
+    }
+
+    // 第一个空位或墓碑
+    std::size_t FindFirstNonFull(std::size_t hash) const noexcept {
+        _ProbeSeq seq{H1(hash), capacity_};
+        while (true) {
+            _Group group{ctrl_ + seq.Offset()};
+            if (auto mask = group.MaskEmptyOrDeleted()) {
+                return seq.Offset(mask.LowestBitSet());
+            }
+            seq.Next();
+        }
+    }
+
+    // 为哈希值为 hash 的新元素占一个槽位 (必要时扩容), 返回槽位下标
+    std::size_t PrepareInsert(std::size_t hash) {
+        std::size_t index = FindFirstNonFull(hash);
+        // NOTE: 复用墓碑不消耗 growth_left_
+        if (growth_left_ == 0 && ctrl_[index] != _kCtrlDeleted) [[unlikely]] {
+            RehashAndGrowIfNecessary();
+            index = FindFirstNonFull(hash);
+        }
+        ++size_;
+        growth_left_ -= ctrl_[index] == _kCtrlEmpty;
+        SetCtrl(index, H2(hash));
+        return index;
+    }
+
+    // NOTE: 位置 index 前后连续的非空字节不足一组时, 任何探测都不可能越过它继续往后找,
+    // 可以直接标记为空并归还 growth_left_; 否则只能留下墓碑
+    void EraseMetaOnly(std::size_t index) noexcept {
+        --size_;
+        std::size_t before = (index - _Group::kWidth) & capacity_;
+        auto empty_after = _Group{ctrl_ + index}.MaskEmpty();
+        auto empty_before = _Group{ctrl_ + before}.MaskEmpty();
+        bool was_never_full =
+            empty_before && empty_after &&
+            empty_after.TrailingZeros() + empty_before.LeadingZeros() < _Group::kWidth;
+        SetCtrl(index, was_never_full ? _kCtrlEmpty : _kCtrlDeleted);
+        growth_left_ += was_never_full;
+    }
+
+    // 同时更新克隆在哨兵之后的那份控制字节
+    void SetCtrl(std::size_t index, _CtrlByte h) noexcept {
+        ctrl_[index] = h;
+        ctrl_[((index - kClonedBytes) & capacity_) + (kClonedBytes & capacity_)] = h;
+    }
+
+    void ResetCtrl() noexcept {
+        std::memset(ctrl_, static_cast<unsigned char>(_kCtrlEmpty), capacity_ + _Group::kWidth);
+        ctrl_[capacity_] = _kCtrlSentinel;
+    }
+
+    // 墓碑很多时原地重建 (容量不变), 否则容量翻倍
+    void RehashAndGrowIfNecessary() {
+        if (capacity_ == 0) {
+            Resize(1);
+        } else if (size_ * 32 <= capacity_ * 25) {
+            Resize(capacity_);
+        } else {
+            Resize(capacity_ * 2 + 1);
+        }
+    }
+
+    void Resize(std::size_t new_capacity) {
+        _CtrlByte* old_ctrl = ctrl_;
+        Slot* old_slots = slots_;
+        std::size_t old_capacity = capacity_;
+
+        CtrlAllocator ctrl_alloc{alloc_};
+        SlotAllocator slot_alloc{alloc_};
+        _CtrlByte* new_ctrl = ctrl_alloc.Allocate(new_capacity + _Group::kWidth);
+        try {
+            slots_ = slot_alloc.Allocate(new_capacity);
+        } catch (...) {
+            ctrl_alloc.Deallocate(new_ctrl, new_capacity + _Group::kWidth);
+            throw;
+        }
+        ctrl_ = new_ctrl;
+        capacity_ = new_capacity;
+        ResetCtrl();
+        growth_left_ = CapacityToGrowth(new_capacity) - size_;
+
+        for (std::size_t i = 0; i < old_capacity; ++i) {
+            if (_IsFull(old_ctrl[i])) {
+                std::size_t hash = HashOf(Policy::Key(old_slots + i));
+                std::size_t index = FindFirstNonFull(hash);
+                SetCtrl(index, H2(hash));
+                Policy::Transfer(slots_ + index, old_slots + i);
+            }
+        }
+        if (old_capacity) {
+            ctrl_alloc.Deallocate(old_ctrl, old_capacity + _Group::kWidth);
+            slot_alloc.Deallocate(old_slots, old_capacity);
+        }
+    }
+
+    void DestroySlots() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<Slot>) {
+            for (std::size_t i = 0; i < capacity_; ++i) {
+                if (_IsFull(ctrl_[i])) {
+                    Policy::Destroy(slots_ + i);
+                }
+            }
+        }
+    }
+
+    void DestroyAndDeallocate() noexcept {
+        if (capacity_ == 0) {
+            return;
+        }
+        DestroySlots();
+        CtrlAllocator{alloc_}.Deallocate(ctrl_, capacity_ + _Group::kWidth);
+        SlotAllocator{alloc_}.Deallocate(slots_, capacity_);
+        ctrl_ = EmptyGroup();
+        slots_ = nullptr;
+        size_ = capacity_ = growth_left_ = 0;
+    }
+
+    _CtrlByte* ctrl_{EmptyGroup()};
+    Slot* slots_{nullptr};
+    std::size_t size_{0};
+    std::size_t capacity_{0};
+    std::size_t growth_left_{0};
+    [[no_unique_address]] Hash hash_{};
+    [[no_unique_address]] Eq eq_{};
+    [[no_unique_address]] Alloc alloc_{};
+};
+
+template <typename Policy, typename Hash, typename Eq, typename Alloc>
+bool operator==(_RawHashSet<Policy, Hash, Eq, Alloc> const& lhs,
+                _RawHashSet<Policy, Hash, Eq, Alloc> const& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    for (auto const& value : lhs) {
+        auto it = rhs.Find(Policy::KeyOf(value));
+        if (it == rhs.end() || !(*it == value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace cutestl
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocator.hpp"
+
+// 内存回收 (EpochDomain / HazardDomain) 的公共部分:
+// - _RetiredList: 待回收指针按批存放, 批次由 cutestl::Allocator 分配并循环复用
+// - _RecordList: 只增不减的无锁记录链表, 记录可被不同线程先后复用
+// - _ThreadRecordCache: 每个线程在每个域上缓存一条记录, 线程退出时归还 (域已析构则跳过)
+
+#if defined(__SANITIZE_THREAD__)
+#define CUTESTL_TSAN 1
+#elif defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define CUTESTL_TSAN 1
+#endif
+#endif
+
+namespace cutestl {
+
+// 回收算法里 store-load 屏障用的 seq_cst 栅栏
+// NOTE: ThreadSanitizer 不建模 atomic_thread_fence (GCC 还会给出 -Wtsan 警告), 此时换成同一个
+// 原子变量上的 seq_cst RMW: 所有屏障在它的修改顺序上全序, 后一个读到前一个, 两侧的读写因此
+// 同样不会互相错过, 而且 TSan 能看到这条同步关系
+inline void _SeqCstFence() noexcept {
+#if defined(CUTESTL_TSAN)
+    static std::atomic<unsigned> word{0};
+    word.fetch_add(0, std::memory_order_seq_cst);
+#else
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// 一个待回收的指针及其类型擦除的删除函数
+struct _Retired {
+    void* ptr_;
+    void (*deleter_)(void*);
+};
+
+// 把 Deleter 变成普通函数指针: 只支持无状态删除器, 这样每项只占两个指针
+template <typename T, typename Deleter>
+void _RetiredDelete(void* ptr) {
+    static_assert(std::is_empty_v<Deleter> && std::is_default_constructible_v<Deleter>,
+                  "Retire 只支持无状态删除器");
+    Deleter{}(static_cast<T*>(ptr));
+}
+
+struct _RetiredBatch {
+    static constexpr std::size_t kCapacity = 64;
+
+    _Retired items_[kCapacity];
+    std::size_t size_;
+    std::uint64_t epoch_;  // 批内所有指针的退休纪元 (EpochDomain 使用)
+    _RetiredBatch* next_;
+};
+
+class _RetiredList {
+public:
+    _RetiredList() noexcept = default;
+    _RetiredList(_RetiredList const&) = delete;
+    _RetiredList& operator=(_RetiredList const&) = delete;
+
+    ~_RetiredList() {
+        ReclaimAll();
+        FreeChain(spare_);
+    }
+
+    // NOTE: 纪元不同或批次已满时开新批次, 保证同一批次的纪元相同
+    void Push(_Retired item, std::uint64_t epoch = 0) {
+        if (!tail_ || tail_->size_ == _RetiredBatch::kCapacity || tail_->epoch_ != epoch) {
+            AppendBatch(epoch);
+        }
+        tail_->items_[tail_->size_++] = item;
+        ++size_;
+    }
+
+    std::size_t Size() const noexcept { return size_; }
+
+    bool Empty() const noexcept { return size_ == 0; }
+
+    // 回收纪元不超过 safe_epoch 的批次, 返回回收个数
+    std::size_t ReclaimUpTo(std::uint64_t safe_epoch) {
+        _RetiredBatch* ready = nullptr;
+        _RetiredBatch** link = &head_;
+        tail_ = nullptr;
+        while (_RetiredBatch* batch = *link) {
+            if (batch->epoch_ <= safe_epoch) {
+                *link = batch->next_;
+                size_ -= batch->size_;
+                batch->next_ = ready;
+                ready = batch;
+            } else {
+                tail_ = batch;
+                link = &batch->next_;
+            }
+        }
+        return RunChain(ready);
+    }
+
+    // 逐个检查, is_protected(ptr) 为 true 的保留, 其余回收 (HazardDomain 使用)
+    template <typename Pred>
+    std::size_t ReclaimUnless(Pred&& is_protected) {
+        _RetiredBatch* chain = std::exchange(head_, nullptr);
+        tail_ = nullptr;
+        size_ = 0;
+        std::size_t reclaimed = 0;
+        // HACK: 先摘下整条链再执行删除器, 删除器里再次 Retire 也是安全的
+        while (chain) {
+            _RetiredBatch* batch = chain;
+            chain = chain->next_;
+            for (std::size_t i = 0; i < batch->size_; ++i) {
+                _Retired item = batch->items_[i];
+                if (is_protected(item.ptr_)) {
+                    Push(item, batch->epoch_);
+                } else {
+                    item.deleter_(item.ptr_);
+                    ++reclaimed;
+                }
+            }
+            Recycle(batch);
+        }
+        return reclaimed;
+    }
+
+    std::size_t ReclaimAll() {
+        _RetiredBatch* chain = std::exchange(head_, nullptr);
+        tail_ = nullptr;
+        size_ = 0;
+        return RunChain(chain);
+    }
+
+    // 把 other 的所有批次接到本链表末尾
+    void Splice(_RetiredList& other) noexcept {
+        if (!other.head_) {
+            return;
+        }
+        if (tail_) {
+            tail_->next_ = other.head_;
+        } else {
+            head_ = other.head_;
+        }
+        tail_ = other.tail_;
+        size_ += other.size_;
+        other.head_ = other.tail_ = nullptr;
+        other.size_ = 0;
+    }
+
+private:
+    using BatchAllocator = Allocator<_RetiredBatch>;
+
+    static constexpr std::size_t kMaxSpare = 4;  // 缓存的空批次上限
+
+    void AppendBatch(std::uint64_t epoch) {
+        _RetiredBatch* batch = spare_;
+        if (batch) {
+            spare_ = batch->next_;
+            --spare_count_;
+        } else {
+            batch = BatchAllocator::Allocate(1);
+        }
+        batch->size_ = 0;
+        batch->epoch_ = epoch;
+        batch->next_ = nullptr;
+        if (tail_) {
+            tail_->next_ = batch;
+        } else {
+            head_ = batch;
+        }
+        tail_ = batch;
+    }
+
+    std::size_t RunChain(_RetiredBatch* chain) {
+        std::size_t reclaimed = 0;
+        while (chain) {
+            _RetiredBatch* batch = chain;
+            chain = chain->next_;
+            for (std::size_t i = 0; i < batch->size_; ++i) {
+                batch->items_[i].deleter_(batch->items_[i].ptr_);
+            }
+            reclaimed += batch->size_;
+            Recycle(batch);
+        }
+        return reclaimed;
+    }
+
+    void Recycle(_RetiredBatch* batch) noexcept {
+        if (spare_count_ < kMaxSpare) {
+            batch->next_ = spare_;
+            spare_ = batch;
+            ++spare_count_;
+        } else {
+            BatchAllocator::Deallocate(batch, 1);
+        }
+    }
+
+    static void FreeChain(_RetiredBatch* chain) noexcept {
+        while (chain) {
+            BatchAllocator::Deallocate(std::exchange(chain, chain->next_), 1);
+        }
+    }
+
+    _RetiredBatch* head_{nullptr};  // 最早退休的批次
+    _RetiredBatch* tail_{nullptr};  // 当前写入的批次
+    _RetiredBatch* spare_{nullptr};
+    std::size_t size_{0};
+    std::size_t spare_count_{0};
+};
+
+// 只增不减的无锁链表, 记录要求有 std::atomic<bool> in_use_ 与 Record* next_ 成员
+// NOTE: 记录在域析构前从不释放, 所以遍历时不需要任何保护
+template <typename Record>
+class _RecordList {
+public:
+    _RecordList() noexcept = default;
+    _RecordList(_RecordList const&) = delete;
+    _RecordList& operator=(_RecordList const&) = delete;
+
+    ~_RecordList() {
+        Record* record = head_.load(std::memory_order_acquire);
+        while (record) {
+            delete std::exchange(record, record->next_);
+        }
+    }
+
+    // 优先复用空闲记录, 没有才新建
+    Record* Acquire() {
+        for (Record* record = head_.load(std::memory_order_acquire); record;
+             record = record->next_) {
+            bool expected = false;
+            if (!record->in_use_.load(std::memory_order_relaxed) &&
+                record->in_use_.compare_exchange_strong(expected, true,
+                                                        std::memory_order_acquire)) {
+                return record;
+            }
+        }
+        auto* record = new Record{};
+        record->in_use_.store(true, std::memory_order_relaxed);
+        Record* head = head_.load(std::memory_order_relaxed);
+        do {
+            record->next_ = head;
+        } while (!head_.compare_exchange_weak(head, record, std::memory_order_release,
+                                              std::memory_order_relaxed));
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return record;
+    }
+
+    static void Release(Record* record) noexcept {
+        record->in_use_.store(false, std::memory_order_release);
+    }
+
+    template <typename F>
+    void ForEach(F&& f) const {
+        for (Record* record = head_.load(std::memory_order_acquire); record;
+             record = record->next_) {
+            f(*record);
+        }
+    }
+
+    // 创建过的记录总数
+    std::size_t Count() const noexcept { return count_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<Record*> head_{nullptr};
+    std::atomic<std::size_t> count_{0};
+};
+
+// 域的存活标记: 线程缓存项共享持有它, 域析构后标记失效但对象仍在,
+// 所以缓存项既不会与之后分配在同一地址上的新域混淆, 线程退出时也能知道不必归还记录
+struct _DomainLife {
+    std::mutex mtx_;    // 域析构与线程退出时归还记录互斥
+    bool alive_{true};  // 受 mtx_ 保护
+};
+
+// 线程在 Domain 上的记录缓存: Domain 需提供 AcquireThreadRecord()/ReleaseThreadRecord(record)
+// 以及成员 std::shared_ptr<_DomainLife> life_
+// NOTE: 域可以先于用过它的线程析构 (例如随数据结构销毁, 而线程池的工作线程还在):
+// 析构时调用 Detach, 其他线程的缓存项随之失效, 不会再访问已释放的记录
+template <typename Domain, typename Record>
+class _ThreadRecordCache {
+public:
+    static Record* Get(Domain* domain) {
+        Cache& cache = Local();
+        for (Entry const& entry : cache.entries_) {
+            if (entry.life_ == domain->life_) {
+                return entry.record_;
+            }
+        }
+        cache.Prune();  // 顺带清理已析构的域, 避免用过大量短命域的线程越积越多
+        Record* record = domain->AcquireThreadRecord();
+        cache.entries_.push_back(Entry{domain->life_, domain, record});
+        return record;
+    }
+
+    // 域析构时调用: 之后任何线程退出都不再回调该域
+    static void Detach(Domain* domain) noexcept {
+        {
+            std::lock_guard lk{domain->life_->mtx_};
+            domain->life_->alive_ = false;
+        }
+        auto& entries = Local().entries_;
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            if (entries[i].life_ == domain->life_) {
+                entries[i] = std::move(entries.back());
+                entries.pop_back();
+                return;
+            }
+        }
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<_DomainLife> life_;
+        Domain* domain_;
+        Record* record_;
+    };
+
+    struct Cache {
+        std::vector<Entry> entries_;
+
+        ~Cache() {
+            for (Entry const& entry : entries_) {
+                // NOTE: 持锁归还, 域的析构会等到归还结束
+                std::lock_guard lk{entry.life_->mtx_};
+                if (entry.life_->alive_) {
+                    entry.domain_->ReleaseThreadRecord(entry.record_);
+                }
+            }
+        }
+
+        void Prune() noexcept {
+            for (std::size_t i = 0; i < entries_.size();) {
+                bool alive;
+                {
+                    std::lock_guard lk{entries_[i].life_->mtx_};
+                    alive = entries_[i].life_->alive_;
+                }
+                if (alive) {
+                    ++i;
+                } else {
+                    entries_[i] = std::move(entries_.back());
+                    entries_.pop_back();
+                }
+            }
+        }
+    };
+
+    static Cache& Local() {
+        thread_local Cache cache;
+        return cache;
+    }
+};
+
+}  // namespace cutestl
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <thread>
+
+// 引用计数策略, SharedPtr 的控制块与 RefCounted 共用
+
+namespace cutestl {
+
+// 引用计数策略: 线程安全的原子计数
+class AtomicRefCount {
+public:
+    explicit AtomicRefCount(std::size_t init) noexcept : count_(init) {}
+
+    // NOTE: 增加引用只需 relaxed: 调用方已经持有一个引用, 计数不可能同时归零
+    void Increment() noexcept { count_.fetch_add(1, std::memory_order_relaxed); }
+
+    // 计数不为 0 时才加一, 返回是否成功
+    // HACK: 不能直接 fetch_add, 否则可能把已经归零 (对象正在析构) 的计数又加回 1
+    bool TryIncrement() noexcept {
+        std::size_t count = count_.load(std::memory_order_relaxed);
+        while (count != 0) {
+            // 成功时 acquire: 与最后一次 Release 的 release 配对, 看到对象的最新状态
+            if (count_.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 减一, 返回是否减到 0
+    // NOTE: 经典 Release !! fetch_sub 和 acquire-release 语义
+    // release 保证本线程对对象的写入在析构前可见, acquire 保证析构的线程看到其他线程的写入
+    bool Decrement() noexcept { return count_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+    std::size_t Load() const noexcept { return count_.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<std::size_t> count_;
+};
+
+// 引用计数策略: 非原子计数, 对象及其所有 SharedPtr/WeakPtr 只能在创建它的线程上使用
+// NOTE: Debug 构建下检查调用线程, 跨线程使用时断言失败
+class LocalRefCount {
+public:
+    explicit LocalRefCount(std::size_t init) noexcept : count_(init) {}
+
+    void Increment() noexcept {
+        CheckThread();
+        ++count_;
+    }
+
+    bool TryIncrement() noexcept {
+        CheckThread();
+        if (count_ == 0) {
+            return false;
+        }
+        ++count_;
+        return true;
+    }
+
+    bool Decrement() noexcept {
+        CheckThread();
+        return --count_ == 0;
+    }
+
+    std::size_t Load() const noexcept {
+        CheckThread();
+        return count_;
+    }
+
+private:
+    void CheckThread() const noexcept {
+#ifndef NDEBUG
+        assert(owner_ == std::this_thread::get_id() && "LocalSharedPtr 不能跨线程使用");
+#endif
+    }
+
+    std::size_t count_;
+#ifndef NDEBUG
+    std::thread::id owner_{std::this_thread::get_id()};
+#endif
+};
+
+}  // namespace cutestl
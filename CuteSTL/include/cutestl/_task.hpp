@@ -0,0 +1,330 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <optional>
+#include <semaphore>
+#include <type_traits>
+#include <utility>
+
+// C++20 协程任务类型 Task<T>
+// 特性:
+//   * 惰性启动: 创建后不执行, 直到被 co_await 或 SyncWait
+//   * 对称转移 (symmetric transfer): 子任务结束后直接切回等待者, 不会爆栈
+//   * 协程帧由 FramePool 分配, 按尺寸分档的线程局部空闲链表回收复用
+//   * 配合 ThreadPool::Schedule() 把协程切换到工作线程上继续执行
+
+namespace cutestl {
+
+//==============================================================================
+// 1. 协程帧分配器
+//==============================================================================
+
+// NOTE: 协程帧大小在编译期确定, 同一个协程函数每次分配的尺寸都相同,
+// 所以按 64 字节分档缓存即可获得很高的复用率
+class FramePool {
+public:
+    static void* Allocate(std::size_t size) {
+        std::size_t cls = SizeClass(size);
+        if (cls < kClassCount) {
+            Cache& cache = t_cache_;
+            if (Node* node = cache.heads_[cls]) {
+                cache.heads_[cls] = node->next_;
+                --cache.counts_[cls];
+                return node;
+            }
+            return ::operator new(ClassBytes(cls));
+        }
+        return ::operator new(size);
+    }
+
+    static void Deallocate(void* p, std::size_t size) noexcept {
+        std::size_t cls = SizeClass(size);
+        if (cls < kClassCount) {
+            (void)&t_reaper_;  // NOTE: odr-use, 保证本线程退出时归还缓存
+            Cache& cache = t_cache_;
+            if (!cache.closed_ && cache.counts_[cls] < kMaxCachedPerClass) {
+                Node* node = static_cast<Node*>(p);
+                node->next_ = cache.heads_[cls];
+                cache.heads_[cls] = node;
+                ++cache.counts_[cls];
+                return;
+            }
+        }
+        ::operator delete(p);
+    }
+
+private:
+    static constexpr std::size_t kGranularity = 64;         // 分档粒度
+    static constexpr std::size_t kClassCount = 16;          // 超过 1 KiB 的帧不缓存
+    static constexpr std::size_t kMaxCachedPerClass = 64;  // 每档最多缓存的帧数
+
+    struct Node {
+        Node* next_;
+    };
+
+    // HACK: Cache 必须平凡析构, 这样线程退出阶段 (reaper 析构之后) 仍可安全访问
+    struct Cache {
+        Node* heads_[kClassCount];
+        std::size_t counts_[kClassCount];
+        bool closed_;
+    };
+
+    struct Reaper {
+        ~Reaper() {
+            Cache& cache = t_cache_;
+            for (std::size_t cls = 0; cls < kClassCount; ++cls) {
+                while (Node* node = cache.heads_[cls]) {
+                    cache.heads_[cls] = node->next_;
+                    ::operator delete(node);
+                }
+                cache.counts_[cls] = 0;
+            }
+            cache.closed_ = true;
+        }
+    };
+
+    static constexpr std::size_t SizeClass(std::size_t size) noexcept {
+        return (size + kGranularity - 1) / kGranularity - 1;
+    }
+    static constexpr std::size_t ClassBytes(std::size_t cls) noexcept {
+        return (cls + 1) * kGranularity;
+    }
+
+    static inline thread_local Cache t_cache_{};
+    static inline thread_local Reaper t_reaper_{};
+};
+
+//==============================================================================
+// 2. Task<T>
+//==============================================================================
+
+template <typename T = void>
+class Task;
+
+// promise 公共部分: 帧分配, 挂起策略, 续体与异常
+class _TaskPromiseBase {
+public:
+    static void* operator new(std::size_t size) { return FramePool::Allocate(size); }
+    static void operator delete(void* p, std::size_t size) noexcept {
+        FramePool::Deallocate(p, size);
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }  // 惰性启动
+
+    // NOTE: 结束时对称转移到等待者, 没有等待者则转移到 noop (即返回 resume 的调用方)
+    class FinalAwaiter {
+    public:
+        bool await_ready() noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            if (auto cont = h.promise().continuation_) {
+                return cont;
+            }
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    void SetContinuation(std::coroutine_handle<> cont) noexcept { continuation_ = cont; }
+
+protected:
+    void RethrowIfException() {
+        if (exception_) {
+            std::rethrow_exception(exception_);
+        }
+    }
+
+private:
+    std::coroutine_handle<> continuation_;  // 等待本任务的协程
+    std::exception_ptr exception_;          // 协程体抛出的异常, 在 co_await 处重新抛出
+};
+
+template <typename T>
+class _TaskPromise : public _TaskPromiseBase {
+public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename U>
+        requires std::is_convertible_v<U&&, T>
+    void return_value(U&& value) {
+        value_.emplace(std::forward<U>(value));
+    }
+
+    T TakeResult() {
+        RethrowIfException();
+        return std::move(*value_);
+    }
+
+private:
+    std::optional<T> value_;
+};
+
+template <>
+class _TaskPromise<void> : public _TaskPromiseBase {
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept {}
+
+    void TakeResult() { RethrowIfException(); }
+};
+
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = _TaskPromise<T>;
+    using handle_type = std::coroutine_handle<promise_type>;
+
+    Task() noexcept = default;
+    explicit Task(handle_type h) noexcept : handle_(h) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            Destroy();
+            handle_ = std::exchange(other.handle_, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() { Destroy(); }
+
+    bool Valid() const noexcept { return handle_ != nullptr; }
+
+    bool Done() const noexcept { return !handle_ || handle_.done(); }
+
+    // co_await task: 启动任务, 完成后在任务结束的线程上恢复等待者
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            handle_type handle_;
+
+            bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+                handle_.promise().SetContinuation(caller);
+                return handle_;  // 对称转移: 直接开始执行任务
+            }
+
+            T await_resume() { return handle_.promise().TakeResult(); }
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    void Destroy() noexcept {
+        if (handle_) {
+            handle_.destroy();
+            handle_ = nullptr;
+        }
+    }
+
+    handle_type handle_;
+};
+
+template <typename T>
+Task<T> _TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>{std::coroutine_handle<_TaskPromise<T>>::from_promise(*this)};
+}
+
+inline Task<void> _TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>{std::coroutine_handle<_TaskPromise<void>>::from_promise(*this)};
+}
+
+//==============================================================================
+// 3. SyncWait: 在普通函数中阻塞等待一个 Task 完成
+//==============================================================================
+
+// 驱动协程: 结束时释放信号量通知等待线程
+class _SyncWaitTask {
+public:
+    class promise_type {
+    public:
+        _SyncWaitTask get_return_object() noexcept {
+            return _SyncWaitTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        auto final_suspend() noexcept {
+            struct Notifier {
+                bool await_ready() noexcept { return false; }
+                void await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                    h.promise().done_->release();  // NOTE: 之后帧由 SyncWait 负责销毁
+                }
+                void await_resume() noexcept {}
+            };
+            return Notifier{};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }  // 异常已由内层 Task 捕获
+
+        std::binary_semaphore* done_{nullptr};
+    };
+
+    explicit _SyncWaitTask(std::coroutine_handle<promise_type> h) noexcept : handle_(h) {}
+    _SyncWaitTask(const _SyncWaitTask&) = delete;
+    _SyncWaitTask& operator=(const _SyncWaitTask&) = delete;
+    ~_SyncWaitTask() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    void Run() {
+        std::binary_semaphore done{0};
+        handle_.promise().done_ = &done;
+        handle_.resume();
+        done.acquire();
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T>
+_SyncWaitTask _MakeSyncWaitTask(Task<T>& task, std::optional<T>& result,
+                                std::exception_ptr& error) {
+    try {
+        result.emplace(co_await std::move(task));
+    } catch (...) {
+        error = std::current_exception();
+    }
+}
+
+inline _SyncWaitTask _MakeSyncWaitTask(Task<void>& task, std::exception_ptr& error) {
+    try {
+        co_await std::move(task);
+    } catch (...) {
+        error = std::current_exception();
+    }
+}
+
+// 阻塞当前线程直到 task 完成, 返回结果或重新抛出异常
+template <typename T>
+T SyncWait(Task<T> task) {
+    std::exception_ptr error;
+    if constexpr (std::is_void_v<T>) {
+        _MakeSyncWaitTask(task, error).Run();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    } else {
+        std::optional<T> result;
+        _MakeSyncWaitTask(task, result, error).Run();
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return std::move(*result);
+    }
+}
+
+}  // namespace cutestl
@@ -1,7 +1,20 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <new>
+
+#include "_hardware.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+// cutestl 风格的分配器: Allocate(n) / Deallocate(p, n), 按元素个数计
+// NOTE: Deallocate 带上分配时的个数 n, 走 sized operator delete 省掉一次大小查找;
+// HugePageAllocator 这类基于 mmap 的分配器也需要它来 munmap
 
 namespace cutestl {
 
@@ -13,11 +26,146 @@ public:
     using value_type = T;
     using pointer = value_type*;
 
+    // 换成为 U 分配内存的同类分配器 (例如 AllocateShared 为控制块分配内存)
+    template <typename U>
+    struct rebind {
+        using other = Allocator<U>;
+    };
+
 public:
+    Allocator() noexcept = default;
+
+    template <typename U>
+    Allocator(Allocator<U> const&) noexcept {}
+
     static pointer Allocate(size_type n) {
         return static_cast<pointer>(operator new(n * sizeof(value_type)));
     }
-    static void Deallocate(pointer p) { operator delete(p); }
+    static void Deallocate(pointer p, size_type n) noexcept {
+        operator delete(p, n * sizeof(value_type));
+    }
+};
+
+// 按 Align 字节对齐的分配器
+// - Align = kCacheLineSize (64): 缓存行对齐, 也满足 AVX-512 对齐加载的要求
+// - Align = 4096: 页对齐
+template <typename T, std::size_t Align = kCacheLineSize>
+class AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "Align 必须是 2 的幂");
+    static_assert(Align >= alignof(T), "Align 不能小于 T 本身的对齐");
+
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = value_type*;
+
+    static constexpr std::size_t kAlignment = Align;
+
+    template <typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, (Align > alignof(U) ? Align : alignof(U))>;
+    };
+
+public:
+    AlignedAllocator() noexcept = default;
+
+    template <typename U, std::size_t A>
+    AlignedAllocator(AlignedAllocator<U, A> const&) noexcept {}
+
+    static pointer Allocate(size_type n) {
+        return static_cast<pointer>(
+            operator new(n * sizeof(value_type), std::align_val_t{Align}));
+    }
+    static void Deallocate(pointer p, size_type n) noexcept {
+        operator delete(p, n * sizeof(value_type), std::align_val_t{Align});
+    }
+};
+
+// 大缓冲区分配器: 不小于 kHugePageSize 的请求直接 mmap, 按 2 MiB 对齐并建议内核使用透明大页,
+// 一个 TLB 项覆盖 2 MiB 而不是 4 KiB; 较小的请求退化为缓存行对齐的 operator new
+// NOTE: mmap 得到的内存已经清零, 配合 AllocateUniqueForOverwrite 可以省掉一次初始化
+// NOTE: 没有 mmap 的平台上全部走 operator new
+template <typename T>
+class HugePageAllocator {
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = value_type*;
+
+    static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+    template <typename U>
+    struct rebind {
+        using other = HugePageAllocator<U>;
+    };
+
+public:
+    HugePageAllocator() noexcept = default;
+
+    template <typename U>
+    HugePageAllocator(HugePageAllocator<U> const&) noexcept {}
+
+    static pointer Allocate(size_type n) {
+        if (n > (std::numeric_limits<size_type>::max() - kHugePageSize) / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+        std::size_t bytes = n * sizeof(value_type);
+        if (!UseMmap(bytes)) {
+            return Small::Allocate(n);
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        // HACK: 多映射一个大页, 再把首尾多余的部分还回去, 得到 2 MiB 对齐的区域
+        std::size_t length = RoundUp(bytes);
+        std::size_t mapped = length + kHugePageSize;
+        void* raw =
+            mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc{};
+        }
+        auto base = reinterpret_cast<std::uintptr_t>(raw);
+        std::uintptr_t aligned = RoundUp(base);
+        if (aligned != base) {
+            munmap(raw, aligned - base);
+        }
+        std::size_t tail = base + mapped - (aligned + length);
+        if (tail != 0) {
+            munmap(reinterpret_cast<void*>(aligned + length), tail);
+        }
+#if defined(MADV_HUGEPAGE)
+        madvise(reinterpret_cast<void*>(aligned), length, MADV_HUGEPAGE);  // 只是建议, 失败也无妨
+#endif
+        return reinterpret_cast<pointer>(aligned);
+#else
+        return Small::Allocate(n);
+#endif
+    }
+
+    static void Deallocate(pointer p, size_type n) noexcept {
+        if (!p) {
+            return;
+        }
+        std::size_t bytes = n * sizeof(value_type);
+        if (!UseMmap(bytes)) {
+            Small::Deallocate(p, n);
+            return;
+        }
+#if defined(__unix__) || defined(__APPLE__)
+        munmap(p, RoundUp(bytes));
+#else
+        Small::Deallocate(p, n);
+#endif
+    }
+
+private:
+    using Small = AlignedAllocator<T, (kCacheLineSize > alignof(T) ? kCacheLineSize : alignof(T))>;
+
+    static bool UseMmap(std::size_t bytes) noexcept { return bytes >= kHugePageSize; }
+
+    static std::size_t RoundUp(std::size_t bytes) noexcept {
+        return (bytes + kHugePageSize - 1) & ~(kHugePageSize - 1);
+    }
 };
 
-}  // namespace cutestl
\ No newline at end of file
+}  // namespace cutestl
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "unique_ptr.hpp"
+
+// 竞技场 (Arena) 分配器: 从大块内存里顺序切分, 单个对象不归还, 整体一次释放
+// 用法 (每个请求一个 Arena):
+//   Arena arena;
+//   auto req = AllocateUnique<Request>(ArenaAllocator<Request>{arena}, ...);  // 析构对象, 不释放内存
+//   ArenaPtr<Token> tok = MakeArenaPtr<Token>(arena, ...);                  // 删除器为空类型
+//   ...
+//   arena.Reset();  // 请求结束, 所有内存一次性回收
+//
+// NOTE: Arena 不是线程安全的; 分配只是指针加法, 没有锁也没有原子操作
+// NOTE: 从 Arena 分配的对象必须在 Reset/析构 Arena 之前被销毁
+
+namespace cutestl {
+
+class Arena {
+public:
+    static constexpr std::size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit Arena(std::size_t block_size = kDefaultBlockSize) noexcept
+        : block_size_(block_size) {}
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    ~Arena() { FreeBlocks(head_); }
+
+    // 分配 bytes 字节, 按 align 对齐 (align 必须是 2 的幂)
+    [[nodiscard]] void* Allocate(std::size_t bytes,
+                                 std::size_t align = alignof(std::max_align_t)) {
+        std::uintptr_t p = AlignUp(cur_, align);
+        // NOTE: 不能写成 p + bytes > end_, bytes 很大时加法回绕, 会越过 AllocateSlow 的溢出检查
+        if (!head_ || p > end_ || bytes > end_ - p) {
+            return AllocateSlow(bytes, align);
+        }
+        cur_ = p + bytes;
+        bytes_used_ += bytes;
+        return reinterpret_cast<void*>(p);
+    }
+
+    // 单个对象的内存不归还, 统一由 Reset/析构释放
+    void Deallocate(void*, std::size_t) noexcept {}
+
+    // 回收全部内存 (不调用析构函数); 保留当前块以便下一轮复用
+    void Reset() noexcept {
+        if (!head_) {
+            return;
+        }
+        FreeBlocks(std::exchange(head_->next_, nullptr));
+        cur_ = head_->Data();
+        end_ = cur_ + head_->size_;
+        bytes_used_ = 0;
+        bytes_reserved_ = head_->size_;
+    }
+
+    // 已分配给调用方的字节数
+    std::size_t BytesUsed() const noexcept { return bytes_used_; }
+
+    // 向系统申请的字节数 (不含块头)
+    std::size_t BytesReserved() const noexcept { return bytes_reserved_; }
+
+private:
+    struct alignas(std::max_align_t) Block {
+        Block* next_;
+        std::size_t size_;
+
+        std::uintptr_t Data() noexcept { return reinterpret_cast<std::uintptr_t>(this + 1); }
+    };
+
+    static std::uintptr_t AlignUp(std::uintptr_t p, std::size_t align) noexcept {
+        return (p + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+    }
+
+    static Block* NewBlock(std::size_t size, Block* next) {
+        if (size > std::numeric_limits<std::size_t>::max() - sizeof(Block)) {
+            throw std::bad_alloc{};
+        }
+        auto* block = static_cast<Block*>(::operator new(sizeof(Block) + size));
+        block->next_ = next;
+        block->size_ = size;
+        return block;
+    }
+
+    static void FreeBlocks(Block* block) noexcept {
+        while (block) {
+            ::operator delete(std::exchange(block, block->next_));
+        }
+    }
+
+    void* AllocateSlow(std::size_t bytes, std::size_t align) {
+        std::size_t need = bytes + align - 1;
+        if (need < bytes) {
+            throw std::bad_alloc{};
+        }
+        bytes_used_ += bytes;
+        // NOTE: 大块单独分配并挂在当前块后面, 不浪费当前块剩余的空间
+        if (head_ && need > block_size_ / 4) {
+            head_->next_ = NewBlock(need, head_->next_);
+            bytes_reserved_ += need;
+            return reinterpret_cast<void*>(AlignUp(head_->next_->Data(), align));
+        }
+        std::size_t size = need > block_size_ ? need : block_size_;
+        head_ = NewBlock(size, head_);
+        bytes_reserved_ += size;
+        std::uintptr_t p = AlignUp(head_->Data(), align);
+        cur_ = p + bytes;
+        end_ = head_->Data() + size;
+        return reinterpret_cast<void*>(p);
+    }
+
+    std::uintptr_t cur_{0};  // 当前块中下一个可用地址
+    std::uintptr_t end_{0};
+    Block* head_{nullptr};   // 当前块; 之后是更早的块与单独分配的大块
+    std::size_t block_size_;
+    std::size_t bytes_used_{0};
+    std::size_t bytes_reserved_{0};
+};
+
+// 从 Arena 分配的 cutestl 风格分配器, 可用于 AllocateUnique/AllocateShared
+template <typename T>
+class ArenaAllocator {
+    template <typename U>
+    friend class ArenaAllocator;
+
+public:
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = value_type*;
+
+    template <typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& other) noexcept : arena_(other.arena_) {}
+
+    pointer Allocate(size_type n) const {
+        if (n > std::numeric_limits<size_type>::max() / sizeof(T)) {
+            throw std::bad_array_new_length{};
+        }
+        return static_cast<pointer>(arena_->Allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void Deallocate(pointer, size_type) const noexcept {}
+
+    Arena& GetArena() const noexcept { return *arena_; }
+
+    template <typename U>
+    bool operator==(ArenaAllocator<U> const& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+
+private:
+    Arena* arena_;
+};
+
+// ArenaPtr 的删除器: 只析构对象 (可平凡析构时什么都不做), 内存随 Arena 整体释放
+// NOTE: 空类型, ArenaPtr 只有一个指针大, 并且可以用生态位放进 Optional
+template <typename T>
+struct ArenaDelete {
+    void operator()(T* p) const noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy_at(p);
+        }
+    }
+};
+
+template <typename T>
+using ArenaPtr = UniquePtr<T, ArenaDelete<T>>;
+
+template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
+[[nodiscard]] ArenaPtr<T> MakeArenaPtr(Arena& arena, Args&&... args) {
+    void* p = arena.Allocate(sizeof(T), alignof(T));
+    return ArenaPtr<T>(::new (p) T(std::forward<Args>(args)...));
+}
+
+}  // namespace cutestl
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "_bitset.hpp"
+#include "_dynamic_bitset.hpp"
+#include "_rank_select.hpp"
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "_hardware.hpp"
+#include "_hash.hpp"
+#include "_key_arg.hpp"
+#include "flat_hash_map.hpp"
+#include "optional.hpp"
+#include "unique_ptr.hpp"
+
+// 分片的线程安全哈希表: 键按哈希的高位分到 2^k 个分片, 每个分片是一把读写锁 + 一个 FlatHashMap
+// 用法:
+//   ConcurrentHashMap<std::uint64_t, SharedPtr<Session>> sessions;
+//   sessions.InsertOrAssign(id, session);
+//   sessions.FindAndApply(id, [](SharedPtr<Session> const& s) { s->Touch(); });
+//   auto s = sessions.ComputeIfAbsent(id, [&] { return MakeShared<Session>(id); });
+//
+// NOTE: 读多写少时, 读者只对所在分片加共享锁, 不同分片的读写互不干扰;
+// 每个分片独占缓存行, 相邻分片的锁不会伪共享
+// NOTE: 不向外暴露迭代器或元素引用 (其他线程的插入会让 FlatHashMap 扩容搬移元素),
+// 访问元素一律通过在锁内执行的回调, 回调里不要再访问同一个表 (可能自锁)
+// NOTE: Size / ForEach 逐个分片加锁, 得到的不是全表的原子快照
+
+namespace cutestl {
+
+template <typename K, typename V, typename Hash = cutestl::Hash<K>,
+          typename Eq = cutestl::EqualTo<K>>
+class ConcurrentHashMap {
+    using Map = FlatHashMap<K, V, Hash, Eq>;
+
+    static constexpr bool kTransparent =
+        requires { typename Hash::is_transparent; typename Eq::is_transparent; };
+
+    template <typename Q>
+    using KeyArg = typename _KeyArg<kTransparent>::template type<Q, K>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    // 默认分片数: 硬件线程数的 4 倍, 向上取 2 的幂
+    static size_type DefaultShardCount() noexcept {
+        size_type threads = std::thread::hardware_concurrency();
+        return std::bit_ceil(std::max<size_type>(threads, 4) * 4);
+    }
+
+    // shard_count 会向上取整到 2 的幂
+    explicit ConcurrentHashMap(size_type shard_count = DefaultShardCount(),
+                               Hash const& hash = Hash(), Eq const& eq = Eq())
+        : shard_count_(std::bit_ceil(std::max<size_type>(shard_count, 1))),
+          shard_shift_(sizeof(std::size_t) * 8 - std::countr_zero(shard_count_)),
+          shards_(make_unique<Shard[]>(shard_count_)),
+          hash_(hash) {
+        // NOTE: 分片含互斥锁, 数组只能默认构造; 再换成带用户哈希与比较器的表,
+        // 否则有状态的 Hash/Eq 在分片内是默认构造的, 与选分片用的 hash_ 不一致
+        for (size_type i = 0; i < shard_count_; ++i) {
+            shards_[i].map_ = Map(0, hash, eq);
+        }
+    }
+
+    ConcurrentHashMap(ConcurrentHashMap const&) = delete;
+    ConcurrentHashMap& operator=(ConcurrentHashMap const&) = delete;
+
+public:
+    // 找到时在共享锁内调用 fn(V const&), 返回是否找到
+    template <typename Q = key_type, typename F>
+    bool FindAndApply(KeyArg<Q> const& key, F&& fn) const {
+        Shard const& shard = ShardFor(key);
+        std::shared_lock lk{shard.mtx_};
+        auto it = shard.map_.Find(key);
+        if (it == shard.map_.end()) {
+            return false;
+        }
+        std::invoke(std::forward<F>(fn), std::as_const(it->second));
+        return true;
+    }
+
+    // 找到时在独占锁内调用 fn(V&) 原地修改, 返回是否找到
+    template <typename Q = key_type, typename F>
+    bool FindAndModify(KeyArg<Q> const& key, F&& fn) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        auto it = shard.map_.Find(key);
+        if (it == shard.map_.end()) {
+            return false;
+        }
+        std::invoke(std::forward<F>(fn), it->second);
+        return true;
+    }
+
+    template <typename Q = key_type>
+    bool Contains(KeyArg<Q> const& key) const {
+        Shard const& shard = ShardFor(key);
+        std::shared_lock lk{shard.mtx_};
+        return shard.map_.Contains(key);
+    }
+
+    // 返回值的拷贝; V 拷贝代价高时用 FindAndApply
+    template <typename Q = key_type>
+    Optional<V> Get(KeyArg<Q> const& key) const {
+        Optional<V> result;
+        FindAndApply<Q>(key, [&](V const& value) { result.Emplace(value); });
+        return result;
+    }
+
+    // 键存在时赋值, 否则插入; 返回是否为新插入
+    template <typename KQ, typename M>
+    bool InsertOrAssign(KQ&& key, M&& value) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        return shard.map_.InsertOrAssign(std::forward<KQ>(key), std::forward<M>(value)).second;
+    }
+
+    // 键不存在时才用 args 构造值; 返回是否为新插入
+    template <typename KQ, typename... Args>
+    bool TryEmplace(KQ&& key, Args&&... args) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        return shard.map_.TryEmplace(std::forward<KQ>(key), std::forward<Args>(args)...).second;
+    }
+
+    // 键不存在时用 factory() 的结果插入, 返回 (已有的或新插入的) 值的拷贝
+    // NOTE: 先在共享锁下查找, 命中时不争抢独占锁; 未命中再加独占锁重查,
+    // 所以同一个键并发调用时 factory 也只会执行一次 (在独占锁内执行)
+    template <typename KQ, typename F>
+    V ComputeIfAbsent(KQ&& key, F&& factory) {
+        Shard& shard = ShardFor(key);
+        {
+            std::shared_lock lk{shard.mtx_};
+            auto it = shard.map_.Find(key);
+            if (it != shard.map_.end()) {
+                return it->second;
+            }
+        }
+        std::unique_lock lk{shard.mtx_};
+        auto it = shard.map_.Find(key);
+        if (it == shard.map_.end()) {
+            it = shard.map_.TryEmplace(std::forward<KQ>(key), std::invoke(std::forward<F>(factory)))
+                     .first;
+        }
+        return it->second;
+    }
+
+    // 返回删除的元素个数 (0 或 1)
+    template <typename Q = key_type>
+    size_type Erase(KeyArg<Q> const& key) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        return shard.map_.Erase(key);
+    }
+
+    // 满足 pred(K const&, V const&) 时删除; 返回是否删除
+    template <typename Q = key_type, typename Pred>
+    bool EraseIf(KeyArg<Q> const& key, Pred&& pred) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        auto it = shard.map_.Find(key);
+        if (it == shard.map_.end() || !std::invoke(std::forward<Pred>(pred), it->first,
+                                                   std::as_const(it->second))) {
+            return false;
+        }
+        shard.map_.Erase(it);
+        return true;
+    }
+
+    // 逐个分片在共享锁内调用 fn(K const&, V const&)
+    template <typename F>
+    void ForEach(F&& fn) const {
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::shared_lock lk{shards_[i].mtx_};
+            for (auto const& [key, value] : shards_[i].map_) {
+                std::invoke(fn, key, value);
+            }
+        }
+    }
+
+    size_type Size() const {
+        size_type size = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::shared_lock lk{shards_[i].mtx_};
+            size += shards_[i].map_.Size();
+        }
+        return size;
+    }
+
+    bool Empty() const { return Size() == 0; }
+
+    void Clear() {
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::unique_lock lk{shards_[i].mtx_};
+            shards_[i].map_.Clear();
+        }
+    }
+
+    // 每个分片预留 n / shard_count 个元素的空间
+    void Reserve(size_type n) {
+        size_type per_shard = (n + shard_count_ - 1) / shard_count_;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::unique_lock lk{shards_[i].mtx_};
+            shards_[i].map_.Reserve(per_shard);
+        }
+    }
+
+    size_type ShardCount() const noexcept { return shard_count_; }
+
+private:
+    struct alignas(kCacheLineSize) Shard {
+        mutable std::shared_mutex mtx_;
+        Map map_;
+    };
+
+    // NOTE: 用打散后哈希的高位选分片; 分片内的 FlatHashMap 用的是低位, 两者互不相关
+    template <typename Q>
+    size_type ShardIndex(Q const& key) const {
+        if (shard_count_ == 1) {
+            return 0;  // 右移 64 位是未定义行为
+        }
+        return _MixHash(hash_(key)) >> shard_shift_;
+    }
+
+    template <typename Q>
+    Shard& ShardFor(Q const& key) {
+        return shards_[ShardIndex(key)];
+    }
+
+    template <typename Q>
+    Shard const& ShardFor(Q const& key) const {
+        return shards_[ShardIndex(key)];
+    }
+
+    size_type shard_count_;
+    int shard_shift_;
+    UniquePtr<Shard[]> shards_;
+    [[no_unique_address]] Hash hash_;
+};
+
+}  // namespace cutestl
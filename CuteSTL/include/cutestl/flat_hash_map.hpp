@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include "_raw_hash_set.hpp"
+#include "allocator.hpp"
+
+// 开放寻址的扁平哈希表: 键值对直接存放在连续数组里 (见 _raw_hash_set.hpp)
+// 用法:
+//   FlatHashMap<String, int> counts;
+//   counts.TryEmplace(String{"alpha"}, 1);
+//   if (auto it = counts.Find(std::string_view{"alpha"}); it != counts.end()) { ... }  // 异构查找
+//
+// NOTE: 与 std::unordered_map 不同, 扩容与删除会让迭代器和元素引用失效
+
+namespace cutestl {
+
+template <typename K, typename V>
+struct _FlatHashMapPolicy {
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K const, V>;
+
+    // HACK: 对外是 pair<const K, V>, 扩容搬移时借 pair<K, V> 的视图移动键, 避免拷贝 const 键
+    // (与 abseil 的做法相同, 依赖两者布局一致)
+    union Slot {
+        Slot() {}
+        ~Slot() {}
+
+        value_type value_;
+        std::pair<K, V> mutable_value_;
+    };
+
+    static value_type& Element(Slot* slot) noexcept { return *std::launder(&slot->value_); }
+
+    static K const& Key(Slot* slot) noexcept { return Element(slot).first; }
+
+    static K const& KeyOf(value_type const& value) noexcept { return value.first; }
+
+    template <typename... Args>
+    static void Construct(Slot* slot, Args&&... args) {
+        std::construct_at(&slot->value_, std::forward<Args>(args)...);
+    }
+
+    static void Destroy(Slot* slot) noexcept { std::destroy_at(&Element(slot)); }
+
+    static void Transfer(Slot* to, Slot* from) noexcept {
+        auto& source = *std::launder(&from->mutable_value_);
+        std::construct_at(&to->mutable_value_, std::move(source));
+        std::destroy_at(&source);
+    }
+};
+
+template <typename K, typename V, typename Hash = cutestl::Hash<K>,
+          typename Eq = cutestl::EqualTo<K>, typename Alloc = Allocator<std::pair<K const, V>>>
+class FlatHashMap : public _RawHashSet<_FlatHashMapPolicy<K, V>, Hash, Eq, Alloc> {
+    using Base = _RawHashSet<_FlatHashMapPolicy<K, V>, Hash, Eq, Alloc>;
+
+    template <typename Q>
+    using KeyArg = typename Base::template KeyArg<Q>;
+
+public:
+    using mapped_type = V;
+    using typename Base::iterator;
+    using typename Base::key_type;
+    using typename Base::value_type;
+
+    using Base::Base;
+
+    FlatHashMap() = default;
+
+    // 键不存在时才用 args 构造值; 键已存在时既不构造值, 也不移动 key 和 args
+    template <typename Q = key_type, typename... Args>
+    std::pair<iterator, bool> TryEmplace(KeyArg<Q> const& key, Args&&... args) {
+        return TryEmplaceImpl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename Q = key_type, typename... Args>
+    std::pair<iterator, bool> TryEmplace(KeyArg<Q>&& key, Args&&... args) {
+        return TryEmplaceImpl(std::forward<Q>(key), std::forward<Args>(args)...);
+    }
+
+    // 键存在时赋值, 否则插入
+    template <typename Q = key_type, typename M>
+    std::pair<iterator, bool> InsertOrAssign(KeyArg<Q> const& key, M&& value) {
+        return InsertOrAssignImpl(key, std::forward<M>(value));
+    }
+
+    template <typename Q = key_type, typename M>
+    std::pair<iterator, bool> InsertOrAssign(KeyArg<Q>&& key, M&& value) {
+        return InsertOrAssignImpl(std::forward<Q>(key), std::forward<M>(value));
+    }
+
+    template <typename Q = key_type>
+    V& operator[](KeyArg<Q> const& key) {
+        return TryEmplace(key).first->second;
+    }
+
+    template <typename Q = key_type>
+    V& operator[](KeyArg<Q>&& key) {
+        return TryEmplaceImpl(std::forward<Q>(key)).first->second;
+    }
+
+    template <typename Q = key_type>
+    V& At(KeyArg<Q> const& key) {
+        auto it = this->Find(key);
+        if (it == this->end()) {
+            throw std::out_of_range("FlatHashMap::At");
+        }
+        return it->second;
+    }
+
+    template <typename Q = key_type>
+    V const& At(KeyArg<Q> const& key) const {
+        return const_cast<FlatHashMap*>(this)->At(key);
+    }
+
+private:
+    template <typename KQ, typename... Args>
+    std::pair<iterator, bool> TryEmplaceImpl(KQ&& key, Args&&... args) {
+        auto [index, inserted] = this->FindOrPrepareInsert(key);
+        if (inserted) {
+            this->EmplaceAt(index, std::piecewise_construct,
+                            std::forward_as_tuple(std::forward<KQ>(key)),
+                            std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return {this->IteratorAt(index), inserted};
+    }
+
+    template <typename KQ, typename M>
+    std::pair<iterator, bool> InsertOrAssignImpl(KQ&& key, M&& value) {
+        auto result = TryEmplaceImpl(std::forward<KQ>(key), std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+};
+
+}  // namespace cutestl
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "_raw_hash_set.hpp"
+#include "allocator.hpp"
+
+// 开放寻址的扁平哈希集合 (见 _raw_hash_set.hpp); 元素不可修改, 迭代器都是 const 的
+
+namespace cutestl {
+
+template <typename K>
+struct _FlatHashSetPolicy {
+    using key_type = K;
+    using value_type = K;
+    using Slot = K;
+
+    static K const& Element(Slot* slot) noexcept { return *slot; }
+
+    static K const& Key(Slot* slot) noexcept { return *slot; }
+
+    static K const& KeyOf(K const& value) noexcept { return value; }
+
+    template <typename... Args>
+    static void Construct(Slot* slot, Args&&... args) {
+        std::construct_at(slot, std::forward<Args>(args)...);
+    }
+
+    static void Destroy(Slot* slot) noexcept { std::destroy_at(slot); }
+
+    static void Transfer(Slot* to, Slot* from) noexcept {
+        std::construct_at(to, std::move(*from));
+        std::destroy_at(from);
+    }
+};
+
+template <typename K, typename Hash = cutestl::Hash<K>, typename Eq = cutestl::EqualTo<K>,
+          typename Alloc = Allocator<K>>
+class FlatHashSet : public _RawHashSet<_FlatHashSetPolicy<K>, Hash, Eq, Alloc> {
+    using Base = _RawHashSet<_FlatHashSetPolicy<K>, Hash, Eq, Alloc>;
+
+public:
+    using Base::Base;
+
+    FlatHashSet() = default;
+};
+
+}  // namespace cutestl
@@ -0,0 +1,415 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "_flat_search.hpp"
+#include "_key_arg.hpp"
+#include "vector.hpp"
+
+// 有序扁平映射: 键和值分别存放在两个按键排序的连续数组里 (与 C++23 std::flat_map 相同的布局)
+// 用法:
+//   FlatMap<int, Route> routes{raw.begin(), raw.end()};  // 一次排序建表
+//   if (auto it = routes.Find(port); it != routes.end()) { use(it->second); }
+//   routes.Insert(batch.begin(), batch.end());           // 批量归并插入
+//
+// NOTE: 适合一次建表, 反复查找的场景
+// - 查找只在键数组上做无分支二分, 键紧密排列, 一条缓存行能装下多个键, 值数组只在命中后访问一次
+// - 单个插入/删除要搬移后面的元素, 是 O(n); 大量插入应攒成一批调用 Insert(first, last)
+// NOTE: 插入和删除会让所有迭代器失效
+// NOTE: 迭代器解引用得到的是 pair<K const&, V&> 代理对象, 不是 pair 的引用
+// NOTE: KeyContainer / MappedContainer 须是迭代器为指针的连续容器 (如 Vector)
+
+namespace cutestl {
+
+template <typename K, typename V, bool kConst>
+class _FlatMapIterator {
+    template <typename K2, typename V2, bool C>
+    friend class _FlatMapIterator;
+
+    template <typename K2, typename V2, typename C, typename KC, typename MC>
+    friend class FlatMap;
+
+    using ValuePtr = std::conditional_t<kConst, V const*, V*>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::pair<K, V>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::pair<K const&, std::conditional_t<kConst, V const&, V&>>;
+
+    // operator-> 返回的代理: 持有 reference, 使 it->first / it->second 可用
+    struct pointer {
+        reference ref_;
+        reference* operator->() noexcept { return &ref_; }
+    };
+
+    _FlatMapIterator() noexcept = default;
+    _FlatMapIterator(_FlatMapIterator const&) noexcept = default;
+    _FlatMapIterator& operator=(_FlatMapIterator const&) noexcept = default;
+
+    // iterator 可以隐式转换为 const_iterator
+    _FlatMapIterator(_FlatMapIterator<K, V, false> const& other) noexcept
+        requires kConst
+        : key_(other.key_), value_(other.value_) {}
+
+    reference operator*() const noexcept { return reference{*key_, *value_}; }
+    pointer operator->() const noexcept { return pointer{**this}; }
+    reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+    _FlatMapIterator& operator++() noexcept { return *this += 1; }
+    _FlatMapIterator& operator--() noexcept { return *this -= 1; }
+
+    _FlatMapIterator operator++(int) noexcept {
+        _FlatMapIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    _FlatMapIterator operator--(int) noexcept {
+        _FlatMapIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    _FlatMapIterator& operator+=(difference_type n) noexcept {
+        key_ += n;
+        value_ += n;
+        return *this;
+    }
+
+    _FlatMapIterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend _FlatMapIterator operator+(_FlatMapIterator it, difference_type n) noexcept {
+        return it += n;
+    }
+    friend _FlatMapIterator operator+(difference_type n, _FlatMapIterator it) noexcept {
+        return it += n;
+    }
+    friend _FlatMapIterator operator-(_FlatMapIterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(_FlatMapIterator const& lhs,
+                                     _FlatMapIterator const& rhs) noexcept {
+        return lhs.key_ - rhs.key_;
+    }
+
+    bool operator==(_FlatMapIterator const& other) const noexcept { return key_ == other.key_; }
+    auto operator<=>(_FlatMapIterator const& other) const noexcept { return key_ <=> other.key_; }
+
+private:
+    _FlatMapIterator(K const* key, ValuePtr value) noexcept : key_(key), value_(value) {}
+
+    K const* key_{nullptr};
+    ValuePtr value_{nullptr};
+};
+
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename KeyContainer = Vector<K>, typename MappedContainer = Vector<V>>
+class FlatMap {
+    static constexpr bool kTransparent = requires { typename Compare::is_transparent; };
+
+    template <typename Q>
+    using KeyArg = typename _KeyArg<kTransparent>::template type<Q, K>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_container_type = KeyContainer;
+    using mapped_container_type = MappedContainer;
+    using iterator = _FlatMapIterator<K, V, false>;
+    using const_iterator = _FlatMapIterator<K, V, true>;
+
+public:
+    FlatMap() = default;
+
+    explicit FlatMap(Compare const& comp) : comp_(comp) {}
+
+    // 从无序区间建表: 整体排序一次再去重, O(n log n); 重复的键保留区间里最先出现的
+    template <std::input_iterator InputIt>
+    FlatMap(InputIt first, InputIt last, Compare const& comp = Compare()) : comp_(comp) {
+        Insert(first, last);
+    }
+
+    FlatMap(std::initializer_list<value_type> init, Compare const& comp = Compare())
+        : FlatMap(init.begin(), init.end(), comp) {}
+
+    // 直接接管已排序且无重复的键数组与值数组, O(1)
+    FlatMap(sorted_unique_t, KeyContainer keys, MappedContainer values,
+            Compare const& comp = Compare())
+        : comp_(comp) {
+        keys_.Swap(keys);
+        values_.Swap(values);
+    }
+
+public:
+    iterator begin() noexcept { return IteratorAt(0); }
+    const_iterator begin() const noexcept { return const_cast<FlatMap*>(this)->begin(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return IteratorAt(Size()); }
+    const_iterator end() const noexcept { return const_cast<FlatMap*>(this)->end(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool Empty() const noexcept { return keys_.Empty(); }
+
+    size_type Size() const noexcept { return keys_.Size(); }
+
+    void Reserve(size_type n) {
+        keys_.Reserve(n);
+        values_.Reserve(n);
+    }
+
+    // 只读访问底层的键/值数组, 例如对所有值做批量处理
+    KeyContainer const& Keys() const noexcept { return keys_; }
+    MappedContainer const& Values() const noexcept { return values_; }
+
+    key_compare KeyComp() const { return comp_; }
+
+public:
+    template <typename Q = key_type>
+    iterator Find(KeyArg<Q> const& key) {
+        size_type index = LowerBoundIndex(key);
+        if (index == Size() || comp_(key, keys_[index])) {
+            return end();
+        }
+        return IteratorAt(index);
+    }
+
+    template <typename Q = key_type>
+    const_iterator Find(KeyArg<Q> const& key) const {
+        return const_cast<FlatMap*>(this)->Find(key);
+    }
+
+    template <typename Q = key_type>
+    bool Contains(KeyArg<Q> const& key) const {
+        return Find(key) != end();
+    }
+
+    template <typename Q = key_type>
+    size_type Count(KeyArg<Q> const& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    template <typename Q = key_type>
+    iterator LowerBound(KeyArg<Q> const& key) {
+        return IteratorAt(LowerBoundIndex(key));
+    }
+
+    template <typename Q = key_type>
+    const_iterator LowerBound(KeyArg<Q> const& key) const {
+        return const_cast<FlatMap*>(this)->LowerBound(key);
+    }
+
+    template <typename Q = key_type>
+    iterator UpperBound(KeyArg<Q> const& key) {
+        return IteratorAt(
+            _BranchlessUpperBound(keys_.begin(), Size(), key, comp_) - keys_.begin());
+    }
+
+    template <typename Q = key_type>
+    const_iterator UpperBound(KeyArg<Q> const& key) const {
+        return const_cast<FlatMap*>(this)->UpperBound(key);
+    }
+
+    template <typename Q = key_type>
+    V& At(KeyArg<Q> const& key) {
+        auto it = Find(key);
+        if (it == end()) {
+            throw std::out_of_range("FlatMap::At");
+        }
+        return it->second;
+    }
+
+    template <typename Q = key_type>
+    V const& At(KeyArg<Q> const& key) const {
+        return const_cast<FlatMap*>(this)->At(key);
+    }
+
+    V& operator[](K const& key) { return TryEmplace(key).first->second; }
+
+    V& operator[](K&& key) { return TryEmplace(std::move(key)).first->second; }
+
+public:
+    std::pair<iterator, bool> Insert(value_type const& value) {
+        return TryEmplace(value.first, value.second);
+    }
+
+    std::pair<iterator, bool> Insert(value_type&& value) {
+        return TryEmplace(std::move(value.first), std::move(value.second));
+    }
+
+    // 批量插入: 先把这一批排序去重, 再与现有元素线性归并, O(n + m log m);
+    // 与单个 Insert 一致, 已存在的键保留原值
+    template <std::input_iterator InputIt>
+    void Insert(InputIt first, InputIt last) {
+        Vector<value_type> batch;
+        if constexpr (std::forward_iterator<InputIt>) {
+            batch.Reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            batch.PushBack(value_type(*first));
+        }
+        SortUnique(batch);
+        MergeBatch(batch);
+    }
+
+    void Insert(std::initializer_list<value_type> init) { Insert(init.begin(), init.end()); }
+
+    // 批量插入已排序且无重复的一批, 省掉排序
+    template <std::input_iterator InputIt>
+    void Insert(sorted_unique_t, InputIt first, InputIt last) {
+        Vector<value_type> batch;
+        for (; first != last; ++first) {
+            batch.PushBack(value_type(*first));
+        }
+        MergeBatch(batch);
+    }
+
+    // 键不存在时才用 args 构造值
+    template <typename KQ, typename... Args>
+    std::pair<iterator, bool> TryEmplace(KQ&& key, Args&&... args) {
+        size_type index = LowerBoundIndex(key);
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {IteratorAt(index), false};
+        }
+        keys_.Insert(keys_.begin() + index, K(std::forward<KQ>(key)));
+        try {
+            values_.Insert(values_.begin() + index, V(std::forward<Args>(args)...));
+        } catch (...) {
+            keys_.Erase(keys_.begin() + index);
+            throw;
+        }
+        return {IteratorAt(index), true};
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> Emplace(Args&&... args) {
+        return Insert(value_type(std::forward<Args>(args)...));
+    }
+
+    // 键存在时赋值, 否则插入
+    template <typename KQ, typename M>
+    std::pair<iterator, bool> InsertOrAssign(KQ&& key, M&& value) {
+        auto result = TryEmplace(std::forward<KQ>(key), std::forward<M>(value));
+        if (!result.second) {
+            result.first->second = std::forward<M>(value);
+        }
+        return result;
+    }
+
+    iterator Erase(const_iterator pos) {
+        size_type index = pos.key_ - keys_.begin();
+        keys_.Erase(keys_.begin() + index);
+        values_.Erase(values_.begin() + index);
+        return IteratorAt(index);
+    }
+
+    iterator Erase(iterator pos) { return Erase(const_iterator{pos}); }
+
+    template <typename Q = key_type>
+    size_type Erase(KeyArg<Q> const& key) {
+        auto it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    void Clear() noexcept {
+        keys_.Clear();
+        values_.Clear();
+    }
+
+    void Swap(FlatMap& other) noexcept {
+        keys_.Swap(other.keys_);
+        values_.Swap(other.values_);
+        std::swap(comp_, other.comp_);
+    }
+
+    friend bool operator==(FlatMap const& lhs, FlatMap const& rhs) {
+        return std::equal(lhs.keys_.begin(), lhs.keys_.end(), rhs.keys_.begin(), rhs.keys_.end()) &&
+               std::equal(lhs.values_.begin(), lhs.values_.end(), rhs.values_.begin(),
+                          rhs.values_.end());
+    }
+
+private:
+    iterator IteratorAt(size_type index) noexcept {
+        return iterator{keys_.begin() + index, values_.begin() + index};
+    }
+
+    template <typename Q>
+    size_type LowerBoundIndex(Q const& key) const {
+        return _BranchlessLowerBound(keys_.begin(), Size(), key, comp_) - keys_.begin();
+    }
+
+    // 稳定排序后去重, 重复的键保留最先出现的
+    void SortUnique(Vector<value_type>& batch) const {
+        auto by_key = [this](value_type const& lhs, value_type const& rhs) {
+            return comp_(lhs.first, rhs.first);
+        };
+        std::stable_sort(batch.begin(), batch.end(), by_key);
+        // NOTE: 已排序, 相邻的 lhs <= rhs, 所以 !(lhs < rhs) 就是等价
+        auto last = std::unique(batch.begin(), batch.end(),
+                                [&](value_type const& lhs, value_type const& rhs) {
+                                    return !by_key(lhs, rhs);
+                                });
+        batch.Erase(last, batch.end());
+    }
+
+    // 把已排序且无重复的一批与现有元素归并到新数组, 键相同时保留现有元素
+    void MergeBatch(Vector<value_type>& batch) {
+        if (batch.Empty()) {
+            return;
+        }
+        KeyContainer keys;
+        MappedContainer values;
+        keys.Reserve(Size() + batch.Size());
+        values.Reserve(Size() + batch.Size());
+        size_type i = 0;
+        size_type j = 0;
+        while (i < Size() && j < batch.Size()) {
+            if (comp_(batch[j].first, keys_[i])) {
+                keys.PushBack(std::move(batch[j].first));
+                values.PushBack(std::move(batch[j].second));
+                ++j;
+                continue;
+            }
+            if (!comp_(keys_[i], batch[j].first)) {
+                ++j;  // 键已存在
+            }
+            keys.PushBack(std::move(keys_[i]));
+            values.PushBack(std::move(values_[i]));
+            ++i;
+        }
+        for (; i < Size(); ++i) {
+            keys.PushBack(std::move(keys_[i]));
+            values.PushBack(std::move(values_[i]));
+        }
+        for (; j < batch.Size(); ++j) {
+            keys.PushBack(std::move(batch[j].first));
+            values.PushBack(std::move(batch[j].second));
+        }
+        keys_.Swap(keys);
+        values_.Swap(values);
+    }
+
+    KeyContainer keys_;
+    MappedContainer values_;
+    [[no_unique_address]] Compare comp_;
+};
+
+}  // namespace cutestl
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+#include "_flat_search.hpp"
+#include "_key_arg.hpp"
+#include "vector.hpp"
+
+// 有序扁平集合: 键按序存放在一个连续数组里, 用法与 FlatMap 相同 (见 flat_map.hpp)
+// NOTE: 元素不可修改, 迭代器都是 const 的; 插入和删除会让所有迭代器失效
+
+namespace cutestl {
+
+template <typename K, typename Compare = std::less<K>, typename KeyContainer = Vector<K>>
+class FlatSet {
+    static constexpr bool kTransparent = requires { typename Compare::is_transparent; };
+
+    template <typename Q>
+    using KeyArg = typename _KeyArg<kTransparent>::template type<Q, K>;
+
+public:
+    using key_type = K;
+    using value_type = K;
+    using key_compare = Compare;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using container_type = KeyContainer;
+    using iterator = K const*;
+    using const_iterator = K const*;
+
+public:
+    FlatSet() = default;
+
+    explicit FlatSet(Compare const& comp) : comp_(comp) {}
+
+    // 从无序区间建表: 整体排序一次再去重, O(n log n)
+    template <std::input_iterator InputIt>
+    FlatSet(InputIt first, InputIt last, Compare const& comp = Compare()) : comp_(comp) {
+        Insert(first, last);
+    }
+
+    FlatSet(std::initializer_list<K> init, Compare const& comp = Compare())
+        : FlatSet(init.begin(), init.end(), comp) {}
+
+    // 直接接管已排序且无重复的键数组, O(1)
+    FlatSet(sorted_unique_t, KeyContainer keys, Compare const& comp = Compare()) : comp_(comp) {
+        keys_.Swap(keys);
+    }
+
+public:
+    const_iterator begin() const noexcept { return keys_.begin(); }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    const_iterator end() const noexcept { return keys_.end(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    bool Empty() const noexcept { return keys_.Empty(); }
+
+    size_type Size() const noexcept { return keys_.Size(); }
+
+    void Reserve(size_type n) { keys_.Reserve(n); }
+
+    KeyContainer const& Keys() const noexcept { return keys_; }
+
+    key_compare KeyComp() const { return comp_; }
+
+public:
+    template <typename Q = key_type>
+    const_iterator Find(KeyArg<Q> const& key) const {
+        const_iterator it = LowerBound(key);
+        if (it == end() || comp_(key, *it)) {
+            return end();
+        }
+        return it;
+    }
+
+    template <typename Q = key_type>
+    bool Contains(KeyArg<Q> const& key) const {
+        return Find(key) != end();
+    }
+
+    template <typename Q = key_type>
+    size_type Count(KeyArg<Q> const& key) const {
+        return Contains(key) ? 1 : 0;
+    }
+
+    template <typename Q = key_type>
+    const_iterator LowerBound(KeyArg<Q> const& key) const {
+        return _BranchlessLowerBound(keys_.begin(), Size(), key, comp_);
+    }
+
+    template <typename Q = key_type>
+    const_iterator UpperBound(KeyArg<Q> const& key) const {
+        return _BranchlessUpperBound(keys_.begin(), Size(), key, comp_);
+    }
+
+public:
+    std::pair<iterator, bool> Insert(K const& key) { return InsertImpl(key); }
+
+    std::pair<iterator, bool> Insert(K&& key) { return InsertImpl(std::move(key)); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> Emplace(Args&&... args) {
+        return InsertImpl(K(std::forward<Args>(args)...));
+    }
+
+    // 批量插入: 先把这一批排序去重, 再与现有元素线性归并, O(n + m log m)
+    template <std::input_iterator InputIt>
+    void Insert(InputIt first, InputIt last) {
+        KeyContainer batch;
+        if constexpr (std::forward_iterator<InputIt>) {
+            batch.Reserve(static_cast<size_type>(std::distance(first, last)));
+        }
+        for (; first != last; ++first) {
+            batch.PushBack(K(*first));
+        }
+        std::sort(batch.begin(), batch.end(), comp_);
+        // NOTE: 已排序, 相邻的 lhs <= rhs, 所以 !(lhs < rhs) 就是等价
+        auto equivalent = [this](K const& lhs, K const& rhs) { return !comp_(lhs, rhs); };
+        batch.Erase(std::unique(batch.begin(), batch.end(), equivalent), batch.end());
+        MergeBatch(batch);
+    }
+
+    void Insert(std::initializer_list<K> init) { Insert(init.begin(), init.end()); }
+
+    // 批量插入已排序且无重复的一批, 省掉排序
+    template <std::input_iterator InputIt>
+    void Insert(sorted_unique_t, InputIt first, InputIt last) {
+        KeyContainer batch;
+        for (; first != last; ++first) {
+            batch.PushBack(K(*first));
+        }
+        MergeBatch(batch);
+    }
+
+    iterator Erase(const_iterator pos) {
+        size_type index = pos - keys_.begin();
+        keys_.Erase(keys_.begin() + index);
+        return keys_.begin() + index;
+    }
+
+    template <typename Q = key_type>
+    size_type Erase(KeyArg<Q> const& key) {
+        const_iterator it = Find(key);
+        if (it == end()) {
+            return 0;
+        }
+        Erase(it);
+        return 1;
+    }
+
+    void Clear() noexcept { keys_.Clear(); }
+
+    void Swap(FlatSet& other) noexcept {
+        keys_.Swap(other.keys_);
+        std::swap(comp_, other.comp_);
+    }
+
+    friend bool operator==(FlatSet const& lhs, FlatSet const& rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    template <typename KQ>
+    std::pair<iterator, bool> InsertImpl(KQ&& key) {
+        size_type index = LowerBound(key) - keys_.begin();
+        if (index != Size() && !comp_(key, keys_[index])) {
+            return {keys_.begin() + index, false};
+        }
+        keys_.Insert(keys_.begin() + index, std::forward<KQ>(key));
+        return {keys_.begin() + index, true};
+    }
+
+    // 把已排序且无重复的一批与现有元素归并到新数组, 键相同时保留现有元素
+    void MergeBatch(KeyContainer& batch) {
+        if (batch.Empty()) {
+            return;
+        }
+        KeyContainer keys;
+        keys.Reserve(Size() + batch.Size());
+        size_type i = 0;
+        size_type j = 0;
+        while (i < Size() && j < batch.Size()) {
+            if (comp_(batch[j], keys_[i])) {
+                keys.PushBack(std::move(batch[j++]));
+                continue;
+            }
+            if (!comp_(keys_[i], batch[j])) {
+                ++j;  // 键已存在
+            }
+            keys.PushBack(std::move(keys_[i++]));
+        }
+        for (; i < Size(); ++i) {
+            keys.PushBack(std::move(keys_[i]));
+        }
+        for (; j < batch.Size(); ++j) {
+            keys.PushBack(std::move(batch[j]));
+        }
+        keys_.Swap(keys);
+    }
+
+    KeyContainer keys_;
+    [[no_unique_address]] Compare comp_;
+};
+
+}  // namespace cutestl
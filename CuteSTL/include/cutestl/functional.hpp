@@ -1,3 +1,5 @@
 #pragma once
 
 #include "_function.hpp"
+#include "_function_ref.hpp"
+#include "_move_only_function.hpp"
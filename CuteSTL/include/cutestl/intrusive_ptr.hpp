@@ -0,0 +1,147 @@
+#pragma once
+
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "_ref_count.hpp"
+
+// 侵入式引用计数: 计数器放在对象内部
+// - 不需要单独的控制块, 对象只分配一次, 访问对象时也少一次指针跳转
+// - IntrusivePtr 只有一个指针大 (SharedPtr 是两个)
+// - 计数跟着对象走, 所以裸指针与 IntrusivePtr 可以随意互相转换, 不会重复计数
+//
+//   struct AstNode : RefCounted<AstNode> { ... };
+//   IntrusivePtr<AstNode> node = MakeIntrusive<AstNode>();
+//   AstNode* raw = node.Get();
+//   IntrusivePtr<AstNode> again{raw};  // 计数变为 2, 而不是另起一个计数
+//
+// NOTE: IntrusivePtr 只要求 T 提供 AddRef()/Release() 成员函数, 不一定继承 RefCounted
+
+namespace cutestl {
+
+// CRTP 基类: Atomic = false 时使用非原子计数, 对象只能在一个线程内使用 (Debug 构建下会检查)
+template <typename T, bool Atomic = true>
+class RefCounted {
+public:
+    void AddRef() const noexcept { count_.Increment(); }
+
+    // 计数归零时按派生类类型析构并释放对象
+    void Release() const noexcept {
+        if (count_.Decrement()) {
+            delete static_cast<T const*>(this);
+        }
+    }
+
+    std::size_t UseCount() const noexcept { return count_.Load(); }
+
+protected:
+    RefCounted() noexcept = default;
+
+    // NOTE: 拷贝对象不拷贝计数, 副本是一个新对象, 从 0 开始计数
+    RefCounted(RefCounted const&) noexcept {}
+    RefCounted& operator=(RefCounted const&) noexcept { return *this; }
+
+    ~RefCounted() = default;
+
+private:
+    // NOTE: 初始为 0, 由第一个 IntrusivePtr 加到 1
+    mutable std::conditional_t<Atomic, AtomicRefCount, LocalRefCount> count_{0};
+};
+
+template <typename T>
+class IntrusivePtr {
+    template <typename U>
+    friend class IntrusivePtr;
+
+public:
+    using element_type = T;
+
+    IntrusivePtr() noexcept = default;
+
+    IntrusivePtr(std::nullptr_t) noexcept {}
+
+    // add_ref = false 表示接管一个已经计过数的引用 (通常来自 Detach)
+    explicit IntrusivePtr(T* ptr, bool add_ref = true) noexcept : p_(ptr) {
+        if (p_ && add_ref) {
+            p_->AddRef();
+        }
+    }
+
+    IntrusivePtr(IntrusivePtr const& other) noexcept : IntrusivePtr(other.p_) {}
+
+    template <typename U>
+        requires std::convertible_to<U*, T*>
+    IntrusivePtr(IntrusivePtr<U> const& other) noexcept : IntrusivePtr(other.p_) {}
+
+    IntrusivePtr(IntrusivePtr&& other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+
+    template <typename U>
+        requires std::convertible_to<U*, T*>
+    IntrusivePtr(IntrusivePtr<U>&& other) noexcept : p_(std::exchange(other.p_, nullptr)) {}
+
+    ~IntrusivePtr() {
+        if (p_) {
+            p_->Release();
+        }
+    }
+
+    // copy-and-swap
+    IntrusivePtr& operator=(IntrusivePtr const& other) noexcept {
+        IntrusivePtr{other}.Swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr&& other) noexcept {
+        IntrusivePtr{std::move(other)}.Swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr& operator=(T* ptr) noexcept {
+        IntrusivePtr{ptr}.Swap(*this);
+        return *this;
+    }
+
+    void Reset() noexcept { IntrusivePtr{}.Swap(*this); }
+
+    void Reset(T* ptr, bool add_ref = true) noexcept { IntrusivePtr{ptr, add_ref}.Swap(*this); }
+
+    // 放弃所有权但不减少计数, 返回裸指针; 之后可用 IntrusivePtr(ptr, false) 接管
+    [[nodiscard]] T* Detach() noexcept { return std::exchange(p_, nullptr); }
+
+    void Swap(IntrusivePtr& other) noexcept { std::swap(p_, other.p_); }
+
+    T* Get() const noexcept { return p_; }
+
+    T& operator*() const noexcept { return *p_; }
+
+    T* operator->() const noexcept { return p_; }
+
+    explicit operator bool() const noexcept { return p_ != nullptr; }
+
+    template <typename U>
+    bool operator==(IntrusivePtr<U> const& other) const noexcept {
+        return p_ == other.Get();
+    }
+
+    bool operator==(std::nullptr_t) const noexcept { return p_ == nullptr; }
+
+    template <typename U>
+    auto operator<=>(IntrusivePtr<U> const& other) const noexcept {
+        return std::compare_three_way{}(p_, other.Get());
+    }
+
+private:
+    T* p_{nullptr};
+};
+
+static_assert(sizeof(IntrusivePtr<RefCounted<int>>) == sizeof(void*));
+
+template <typename T, typename... Args>
+IntrusivePtr<T> MakeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>{new T(std::forward<Args>(args)...)};
+}
+
+}  // namespace cutestl
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <utility>
 
 #include "allocator.hpp"
 
@@ -86,16 +89,38 @@ public:
     using iterator = _ListIterator<value_type>;
 
 private:
-    Node* dummy_;  // 哨兵节点指针
+    Node* dummy_;        // 哨兵节点指针
+    size_type size_{0};  // 元素个数
 
 private:
     static Node* AllocateNode() { return Alloc::Allocate(1); }
-    static void DeallocateNode(Node* p) { Alloc::Deallocate(p); }
+    static void DeallocateNode(Node* p) { Alloc::Deallocate(p, 1); }
     static Node* CreateNode(value_type const& value) {
         Node* node{AllocateNode()};
         new (&node->data_) value_type(value);  // NOTE: placement new, 在 &node->data 内存上构造
         return node;
     }
+    template <typename... Args>
+    static Node* CreateNodeInPlace(Args&&... args) {
+        Node* node{AllocateNode()};
+        try {
+            std::construct_at(&node->data_, std::forward<Args>(args)...);
+        } catch (...) {
+            DeallocateNode(node);
+            throw;
+        }
+        return node;
+    }
+
+    // 把 node 挂到 pos 前面
+    iterator LinkBefore(iterator pos, Node* node) {
+        node->prev_ = pos->prev_;
+        node->next_ = pos.node_;
+        pos->prev_->next_ = node;
+        pos->prev_ = node;
+        ++size_;
+        return node;
+    }
 
 public:
     // 默认构造函数: dummy 的 next prev 指向自己
@@ -104,16 +129,49 @@ public:
         dummy_->next_ = dummy_;
     }
 
+    // NOTE: dummy 只分配内存, 没有构造 data_, 所以只析构其他节点
+    ~List() {
+        Clear();
+        DeallocateNode(dummy_);
+    }
+
+    // NOTE: 节点归 List 所有, 禁止浅拷贝
+    List(List const&) = delete;
+    List& operator=(List const&) = delete;
+
 public:
     iterator Insert(iterator pos, value_type const& value) {
-        Node* new_node{CreateNode(value)};
-        new_node->prev_ = pos->prev_;
-        new_node->next_ = pos.node_;
-        pos->prev_->next_ = new_node;
-        pos->prev_ = new_node;
-        return new_node;
+        return LinkBefore(pos, CreateNode(value));
+    }
+
+    // 在 pos 前原地构造, 元素不需要可拷贝或可移动 (例如含 std::atomic 成员)
+    template <typename... Args>
+    iterator Emplace(iterator pos, Args&&... args) {
+        return LinkBefore(pos, CreateNodeInPlace(std::forward<Args>(args)...));
+    }
+
+    // 返回被删除节点的下一个位置; 其他节点的迭代器不受影响
+    iterator Erase(iterator pos) {
+        Node* node{pos.node_};
+        Node* next{node->next_};
+        node->prev_->next_ = next;
+        next->prev_ = node->prev_;
+        std::destroy_at(&node->data_);
+        DeallocateNode(node);
+        --size_;
+        return next;
+    }
+
+    void Clear() {
+        while (size_ != 0) {
+            Erase(Begin());
+        }
     }
 
+    size_type Size() const { return size_; }
+
+    bool Empty() const { return size_ == 0; }
+
     iterator Insert(iterator pos, size_type count, value_type const& value) {
         iterator new_pos{pos};
         while (count--) {
@@ -121,9 +179,21 @@ public:
         }
         return new_pos;
     }
-    // TODO:
-    template <typename InputIt>
-    iterator Insert(iterator pos, InputIt first, InputIt last) {}
+
+    // 返回插入的第一个元素; 区间为空时返回 pos
+    template <std::input_iterator InputIt>
+    iterator Insert(iterator pos, InputIt first, InputIt last) {
+        iterator ret{pos};
+        bool first_inserted{true};
+        for (; first != last; ++first) {
+            iterator it{Insert(pos, *first)};
+            if (first_inserted) {
+                ret = it;
+                first_inserted = false;
+            }
+        }
+        return ret;
+    }
 
     void Show() const {
         for (iterator it = Begin(); it != End(); ++it) {
@@ -0,0 +1,270 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+#include "_hardware.hpp"
+#include "_hash.hpp"
+#include "flat_hash_map.hpp"
+#include "list.hpp"
+#include "shared_ptr.hpp"
+#include "unique_ptr.hpp"
+
+// 分片的线程安全缓存, 按字节预算淘汰
+// 用法:
+//   LruCache<std::string, Blob> cache{64 << 20};           // 总预算 64 MiB
+//   cache.Put(key, MakeShared<Blob>(...), blob_bytes);      // charge: 这一项占用的字节数
+//   if (SharedPtr<Blob> blob = cache.Get(key)) { ... }      // 淘汰后 blob 仍然有效
+//
+// NOTE: 淘汰策略是 CLOCK (近似 LRU)
+// - 每个分片的元素挂在一个环形链表 (List) 上, FlatHashMap 从键索引到链表节点
+// - 命中只加共享锁, 把元素的 "最近访问" 位置 1 (已经是 1 就不写, 避免缓存行来回失效),
+//   不需要像严格 LRU 那样加独占锁把节点挪到链表头
+// - 超出预算时时钟指针沿链表扫描: 访问位为 1 的清零放过 (第二次机会), 为 0 的淘汰
+// - 新元素插在指针前面, 也就是最后才被扫描到
+// NOTE: 值以 SharedPtr<V> 交出, 淘汰/覆盖只是放掉缓存自己的那份引用, 不影响正在使用的读者
+// NOTE: 每个分片的预算是 总预算 / 分片数; charge 大于分片预算的元素不会被缓存 (计为一次淘汰),
+// 同键的旧值一并删除, 分片里的其他元素不受影响
+
+namespace cutestl {
+
+// 缓存度量快照
+struct LruCacheStats {
+    std::uint64_t hits = 0;       // Get 命中数
+    std::uint64_t misses = 0;     // Get 未命中数
+    std::uint64_t inserts = 0;    // Put 新插入数 (覆盖已有的键不计)
+    std::uint64_t evictions = 0;  // 因超出预算而淘汰的元素数
+    std::size_t entries = 0;      // 当前元素数
+    std::size_t bytes = 0;        // 当前占用的字节数 (各元素 charge 之和)
+
+    double HitRate() const noexcept {
+        std::uint64_t total = hits + misses;
+        return total ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+    }
+};
+
+template <typename K, typename V, typename Hash = cutestl::Hash<K>,
+          typename Eq = cutestl::EqualTo<K>>
+class LruCache {
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using size_type = std::size_t;
+
+    static constexpr size_type kDefaultShardCount = 16;
+
+    // shard_count 会向上取整到 2 的幂
+    explicit LruCache(size_type capacity_bytes, size_type shard_count = kDefaultShardCount)
+        : shard_count_(std::bit_ceil(std::max<size_type>(shard_count, 1))),
+          shard_shift_(sizeof(std::size_t) * 8 - std::countr_zero(shard_count_)),
+          shards_(make_unique<Shard[]>(shard_count_)) {
+        for (size_type i = 0; i < shard_count_; ++i) {
+            shards_[i].budget_ = capacity_bytes / shard_count_;
+        }
+    }
+
+    LruCache(LruCache const&) = delete;
+    LruCache& operator=(LruCache const&) = delete;
+
+public:
+    // 命中时返回值并标记为最近访问, 否则返回空指针
+    SharedPtr<V> Get(K const& key) {
+        Shard& shard = ShardFor(key);
+        std::shared_lock lk{shard.mtx_};
+        auto it = shard.index_.Find(key);
+        if (it == shard.index_.end()) {
+            shard.misses_.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Entry& entry = *it->second;
+        if (!entry.referenced_.load(std::memory_order_relaxed)) {
+            entry.referenced_.store(true, std::memory_order_relaxed);
+        }
+        shard.hits_.fetch_add(1, std::memory_order_relaxed);
+        return entry.value_;
+    }
+
+    // 不影响访问位与命中计数
+    bool Contains(K const& key) const {
+        Shard const& shard = ShardFor(key);
+        std::shared_lock lk{shard.mtx_};
+        return shard.index_.Contains(key);
+    }
+
+    // 插入或覆盖, 然后按需淘汰; charge 是这一项计入预算的字节数
+    void Put(K const& key, SharedPtr<V> value, size_type charge = sizeof(V)) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        auto it = shard.index_.Find(key);
+        if (charge > shard.budget_) {
+            // NOTE: 放进链表再淘汰会先把其他元素全部扫掉, 所以直接丢弃;
+            // 旧值已被调用方替换, 不能再返回给读者
+            if (it != shard.index_.end()) {
+                auto node = it->second;
+                shard.index_.Erase(it);
+                Unlink(shard, node);
+            }
+            ++shard.evictions_;
+            return;
+        }
+        if (it != shard.index_.end()) {
+            Entry& entry = *it->second;
+            shard.used_ = shard.used_ - entry.charge_ + charge;
+            entry.value_ = std::move(value);
+            entry.charge_ = charge;
+            entry.referenced_.store(true, std::memory_order_relaxed);
+        } else {
+            auto node = shard.entries_.Emplace(shard.hand_, key, std::move(value), charge);
+            try {
+                shard.index_.TryEmplace(key, node);
+            } catch (...) {
+                shard.entries_.Erase(node);
+                throw;
+            }
+            shard.used_ += charge;
+            ++shard.inserts_;
+        }
+        EvictIfNeeded(shard);
+    }
+
+    // 返回是否删除
+    bool Erase(K const& key) {
+        Shard& shard = ShardFor(key);
+        std::unique_lock lk{shard.mtx_};
+        auto it = shard.index_.Find(key);
+        if (it == shard.index_.end()) {
+            return false;
+        }
+        auto node = it->second;
+        shard.index_.Erase(it);
+        Unlink(shard, node);
+        return true;
+    }
+
+    void Clear() {
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard& shard = shards_[i];
+            std::unique_lock lk{shard.mtx_};
+            shard.index_.Clear();
+            shard.entries_.Clear();
+            shard.hand_ = shard.entries_.End();
+            shard.used_ = 0;
+        }
+    }
+
+    size_type Size() const {
+        size_type size = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::shared_lock lk{shards_[i].mtx_};
+            size += shards_[i].entries_.Size();
+        }
+        return size;
+    }
+
+    // 各分片 charge 之和
+    size_type BytesUsed() const {
+        size_type bytes = 0;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            std::shared_lock lk{shards_[i].mtx_};
+            bytes += shards_[i].used_;
+        }
+        return bytes;
+    }
+
+    LruCacheStats Stats() const {
+        LruCacheStats stats;
+        for (size_type i = 0; i < shard_count_; ++i) {
+            Shard const& shard = shards_[i];
+            std::shared_lock lk{shard.mtx_};
+            stats.hits += shard.hits_.load(std::memory_order_relaxed);
+            stats.misses += shard.misses_.load(std::memory_order_relaxed);
+            stats.inserts += shard.inserts_;
+            stats.evictions += shard.evictions_;
+            stats.entries += shard.entries_.Size();
+            stats.bytes += shard.used_;
+        }
+        return stats;
+    }
+
+    size_type ShardCount() const noexcept { return shard_count_; }
+
+private:
+    struct Entry {
+        Entry(K const& key, SharedPtr<V>&& value, size_type charge)
+            : key_(key), value_(std::move(value)), charge_(charge) {}
+
+        K key_;  // 淘汰时用来删除索引
+        SharedPtr<V> value_;
+        size_type charge_;
+        std::atomic<bool> referenced_{false};  // CLOCK 访问位: 共享锁下由 Get 置位
+    };
+
+    using EntryList = List<Entry>;
+    using EntryIter = typename EntryList::iterator;
+
+    struct alignas(kCacheLineSize) Shard {
+        mutable std::shared_mutex mtx_;
+        FlatHashMap<K, EntryIter, Hash, Eq> index_;
+        EntryList entries_;
+        EntryIter hand_{entries_.End()};  // 时钟指针, 指向下一个要检查的元素
+        size_type used_{0};
+        size_type budget_{0};
+        std::atomic<std::uint64_t> hits_{0};  // 共享锁下更新, 所以是原子的
+        std::atomic<std::uint64_t> misses_{0};
+        std::uint64_t inserts_{0};  // 独占锁下更新
+        std::uint64_t evictions_{0};
+    };
+
+    // 独占锁内调用: 沿时钟指针淘汰, 直到不超预算; 每个元素最多被放过一次, 所以最多扫两圈
+    static void EvictIfNeeded(Shard& shard) {
+        while (shard.used_ > shard.budget_ && !shard.entries_.Empty()) {
+            if (shard.hand_ == shard.entries_.End()) {
+                shard.hand_ = shard.entries_.Begin();
+            }
+            Entry& entry = *shard.hand_;
+            if (entry.referenced_.load(std::memory_order_relaxed)) {
+                entry.referenced_.store(false, std::memory_order_relaxed);
+                ++shard.hand_;
+                continue;
+            }
+            shard.index_.Erase(entry.key_);
+            Unlink(shard, shard.hand_);
+            ++shard.evictions_;
+        }
+    }
+
+    // 从链表摘除并扣除 charge; 指针恰好指向它时前移一位
+    static void Unlink(Shard& shard, EntryIter node) {
+        shard.used_ -= node->data_.charge_;
+        bool at_hand = shard.hand_ == node;
+        EntryIter next = shard.entries_.Erase(node);
+        if (at_hand) {
+            shard.hand_ = next;
+        }
+    }
+
+    // NOTE: 用打散后哈希的高位选分片, 与分片内 FlatHashMap 用的低位互不相关
+    size_type ShardIndex(K const& key) const {
+        if (shard_count_ == 1) {
+            return 0;  // 右移 64 位是未定义行为
+        }
+        return _MixHash(hash_(key)) >> shard_shift_;
+    }
+
+    Shard& ShardFor(K const& key) { return shards_[ShardIndex(key)]; }
+
+    Shard const& ShardFor(K const& key) const { return shards_[ShardIndex(key)]; }
+
+    size_type shard_count_;
+    int shard_shift_;
+    UniquePtr<Shard[]> shards_;
+    [[no_unique_address]] Hash hash_;
+};
+
+}  // namespace cutestl
@@ -1,6 +1,12 @@
 #pragma once
 
 #include <exception>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "_niche.hpp"
 
 namespace cutestl {
 
@@ -19,89 +25,375 @@ struct BadOptionalAccess : public std::exception {
 // 这里使用 explicit 的原因：
 // 使用户无法使用{}构造，只能使用全局变量 nullopt 构造
 struct nullopt_t {
-    explicit nullopt_t() = default;
+    explicit constexpr nullopt_t() = default;
+};
+
+inline constexpr nullopt_t nullopt{};
+
+template <typename T>
+class Optional;
+
+// 有生态位时 m_has_value 换成这个空类型, 配合 [[no_unique_address]] 不占空间
+struct _OptionalNicheFlag {
+    constexpr _OptionalNicheFlag(bool = false) noexcept {}
 };
 
-inline nullopt_t nullopt;
+template <typename T>
+inline constexpr bool _kIsOptional = false;
+
+template <typename T>
+inline constexpr bool _kIsOptional<Optional<T>> = true;
 
+// NOTE: 特殊成员函数按 T 的性质有条件地平凡 (C++20 requires 子句选择重载)
+// - T 可平凡拷贝时 Optional<T> 也可平凡拷贝, 例如 Optional<int> 可以用寄存器传参/返回
+// - T 可平凡析构时 Optional<T> 的析构函数也是平凡的
+// NOTE: T 有生态位 (见 _niche.hpp, 如指针/UniquePtr/SharedPtr) 时, 空状态存成 T 的哨兵值,
+// 不再需要 m_has_value, sizeof(Optional<T*>) == sizeof(T*)
 template <typename T>
-struct Optional {
+class Optional {
+    static_assert(!std::is_reference_v<T>, "Optional 不支持引用类型");
+    static_assert(!std::is_same_v<std::remove_cv_t<T>, nullopt_t>);
+    static_assert(!std::is_same_v<std::remove_cv_t<T>, std::in_place_t>);
+
+    static constexpr bool kNiche = _HasNiche<T>;
+
+    static constexpr bool kTrivialCopyAssign = std::is_trivially_copy_constructible_v<T> &&
+                                               std::is_trivially_copy_assignable_v<T> &&
+                                               std::is_trivially_destructible_v<T>;
+    static constexpr bool kTrivialMoveAssign = std::is_trivially_move_constructible_v<T> &&
+                                               std::is_trivially_move_assignable_v<T> &&
+                                               std::is_trivially_destructible_v<T>;
+
+public:
+    using value_type = T;
+
     // 默认构造函数
     // 不使用 m_value() 是因为T可能是没有默认构造函数的用户自定义类型
-    Optional() : m_has_value(false), m_nullopt() {}
+    constexpr Optional() noexcept : m_nullopt() { InitEmpty(); }
 
     // Optional opt(nullopt); 构造空 Optional 对象
     // nullopt 属于 nullopt_t 类型
-    // 不使用 m_value() 是因为T可能是没有默认构造函数的用户自定义类型
-    Optional(nullopt_t) : m_has_value(false), m_nullopt() {};
+    constexpr Optional(nullopt_t) noexcept : m_nullopt() { InitEmpty(); }
+
+    // 就地构造: Optional<std::string> opt(std::in_place, 3, 'x');
+    template <typename... Args>
+        requires std::is_constructible_v<T, Args...>
+    constexpr explicit Optional(std::in_place_t, Args &&...args)
+        : m_value(std::forward<Args>(args)...), m_has_value(true) {}
 
-    // 构造函数
-    Optional(T value) : m_has_value(true), m_value(value) {}
+    // 从值构造 (完美转发, 不再多拷贝一次)
+    // 只有 U 能隐式转换为 T 时才允许隐式构造
+    template <typename U = T>
+        requires(std::is_constructible_v<T, U &&> &&
+                 !std::is_same_v<std::remove_cvref_t<U>, std::in_place_t> &&
+                 !std::is_same_v<std::remove_cvref_t<U>, Optional> &&
+                 !std::is_same_v<std::remove_cvref_t<U>, nullopt_t>)
+    constexpr explicit(!std::is_convertible_v<U &&, T>) Optional(U &&value)
+        : m_value(std::forward<U>(value)), m_has_value(true) {}
+
+    // 拷贝构造
+    constexpr Optional(Optional const &)
+        requires std::is_trivially_copy_constructible_v<T>
+    = default;
+
+    constexpr Optional(Optional const &other)
+        requires(std::is_copy_constructible_v<T> && !std::is_trivially_copy_constructible_v<T>)
+        : m_nullopt() {
+        if (other.HasValue()) {
+            Construct(other.m_value);
+        } else {
+            InitEmpty();
+        }
+    }
+
+    // 移动构造
+    constexpr Optional(Optional &&)
+        requires std::is_trivially_move_constructible_v<T>
+    = default;
+
+    constexpr Optional(Optional &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        requires(std::is_move_constructible_v<T> && !std::is_trivially_move_constructible_v<T>)
+        : m_nullopt() {
+        if (other.HasValue()) {
+            Construct(std::move(other.m_value));
+        } else {
+            InitEmpty();
+        }
+    }
+
+    // 拷贝赋值
+    constexpr Optional &operator=(Optional const &)
+        requires kTrivialCopyAssign
+    = default;
+
+    constexpr Optional &operator=(Optional const &other)
+        requires(std::is_copy_constructible_v<T> && std::is_copy_assignable_v<T> &&
+                 !kTrivialCopyAssign)
+    {
+        Assign(other);
+        return *this;
+    }
+
+    // 移动赋值
+    constexpr Optional &operator=(Optional &&)
+        requires kTrivialMoveAssign
+    = default;
+
+    constexpr Optional &operator=(Optional &&other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>)
+        requires(std::is_move_constructible_v<T> && std::is_move_assignable_v<T> &&
+                 !kTrivialMoveAssign)
+    {
+        Assign(std::move(other));
+        return *this;
+    }
+
+    constexpr Optional &operator=(nullopt_t) noexcept {
+        Reset();
+        return *this;
+    }
+
+    // 从值赋值: 有值时赋值, 否则构造
+    template <typename U = T>
+        requires(!std::is_same_v<std::remove_cvref_t<U>, Optional> &&
+                 std::is_constructible_v<T, U> && std::is_assignable_v<T &, U>)
+    constexpr Optional &operator=(U &&value) {
+        if (HasValue()) {
+            m_value = std::forward<U>(value);
+        } else {
+            Construct(std::forward<U>(value));
+        }
+        return *this;
+    }
 
     // 析构函数
     // m_nullopt 不需要析构
-    ~Optional() {
-        if (m_has_value) {
+    constexpr ~Optional()
+        requires std::is_trivially_destructible_v<T>
+    = default;
+
+    constexpr ~Optional() {
+        if (HasValue()) {
             m_value.~T();
         }
     }
 
-    bool HasValue() const { return m_has_value; }
-
-    // const版本Value()
-    // 返回const引用
-    // const T& Value() const {
-    //     if (!m_has_value) {
-    //         // 注意此处异常处理
-    //         throw BadOptionalAccess();
-    //     }
-    //     return m_value;
-    // }
-
-    // const T&& Value() const {
-    //     if (!m_has_value) {
-    //         throw BadOptionalAccess();
-    //     }
-    //     return std::move(m_value);
-    // }
-
-    // // 非const版本Value()
-    // // 返回非const引用
-    // T& Value() {
-    //     if (!m_has_value) {
-    //         // 注意此处异常处理
-    //         throw BadOptionalAccess();
-    //     }
-    //     return m_value;
-    // }
-    const T &Value() const & {
-        if (!m_has_value) throw BadOptionalAccess();
+    //--------------------------------------------------------------------------
+    // 观察器
+    //--------------------------------------------------------------------------
+
+    constexpr bool HasValue() const noexcept {
+        if constexpr (kNiche) {
+            return !NicheTraits<T>::IsEmpty(m_value);
+        } else {
+            return m_has_value;
+        }
+    }
+
+    constexpr explicit operator bool() const noexcept { return HasValue(); }
+
+    constexpr const T &Value() const & {
+        if (!HasValue()) throw BadOptionalAccess();
         return m_value;
     }
 
-    T &Value() & {
-        if (!m_has_value) throw BadOptionalAccess();
+    constexpr T &Value() & {
+        if (!HasValue()) throw BadOptionalAccess();
         return m_value;
     }
 
-    const T &&Value() const && {
-        if (!m_has_value) throw BadOptionalAccess();
+    constexpr const T &&Value() const && {
+        if (!HasValue()) throw BadOptionalAccess();
         return std::move(m_value);
     }
 
-    T &&Value() && {
-        if (!m_has_value) throw BadOptionalAccess();
+    constexpr T &&Value() && {
+        if (!HasValue()) throw BadOptionalAccess();
         return std::move(m_value);
     }
 
+    // NOTE: 解引用不检查是否有值 (与 std::optional 一致), 需要检查请用 Value()
+    constexpr const T &operator*() const & noexcept { return m_value; }
+    constexpr T &operator*() & noexcept { return m_value; }
+    constexpr const T &&operator*() const && noexcept { return std::move(m_value); }
+    constexpr T &&operator*() && noexcept { return std::move(m_value); }
+
+    constexpr const T *operator->() const noexcept { return std::addressof(m_value); }
+    constexpr T *operator->() noexcept { return std::addressof(m_value); }
+
+    template <typename U>
+    constexpr T ValueOr(U &&fallback) const & {
+        return HasValue() ? m_value : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    template <typename U>
+    constexpr T ValueOr(U &&fallback) && {
+        return HasValue() ? std::move(m_value) : static_cast<T>(std::forward<U>(fallback));
+    }
+
+    //--------------------------------------------------------------------------
+    // 修改器
+    //--------------------------------------------------------------------------
+
+    // 销毁旧值 (如果有), 就地构造新值
+    template <typename... Args>
+    constexpr T &Emplace(Args &&...args) {
+        Reset();
+        Construct(std::forward<Args>(args)...);
+        return m_value;
+    }
+
+    constexpr void Reset() noexcept {
+        if (HasValue()) {
+            m_value.~T();
+            m_has_value = false;
+            InitEmpty();
+        }
+    }
+
+    constexpr void Swap(Optional &other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                  std::is_nothrow_swappable_v<T>) {
+        if (HasValue() && other.HasValue()) {
+            using std::swap;
+            swap(m_value, other.m_value);
+        } else if (HasValue()) {
+            other.Construct(std::move(m_value));
+            Reset();
+        } else if (other.HasValue()) {
+            Construct(std::move(other.m_value));
+            other.Reset();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+    // 单子操作 (monadic operations)
+    //--------------------------------------------------------------------------
+
+    // 有值时调用 f(value), f 必须返回 Optional; 无值时返回空的同类型 Optional
+    template <typename F>
+    constexpr auto AndThen(F &&f) & {
+        return AndThenImpl(*this, std::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto AndThen(F &&f) const & {
+        return AndThenImpl(*this, std::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto AndThen(F &&f) && {
+        return AndThenImpl(std::move(*this), std::forward<F>(f));
+    }
+
+    // 有值时返回 Optional(f(value)), 无值时返回空 Optional
+    template <typename F>
+    constexpr auto Transform(F &&f) & {
+        return TransformImpl(*this, std::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto Transform(F &&f) const & {
+        return TransformImpl(*this, std::forward<F>(f));
+    }
+    template <typename F>
+    constexpr auto Transform(F &&f) && {
+        return TransformImpl(std::move(*this), std::forward<F>(f));
+    }
+
+    // 有值时返回自身, 无值时返回 f() (f 必须返回 Optional<T>)
+    template <typename F>
+        requires std::is_same_v<std::remove_cvref_t<std::invoke_result_t<F>>, Optional>
+    constexpr Optional OrElse(F &&f) const & {
+        return HasValue() ? *this : std::invoke(std::forward<F>(f));
+    }
+    template <typename F>
+        requires std::is_same_v<std::remove_cvref_t<std::invoke_result_t<F>>, Optional>
+    constexpr Optional OrElse(F &&f) && {
+        return HasValue() ? std::move(*this) : std::invoke(std::forward<F>(f));
+    }
+
 private:
-    bool m_has_value;
+    template <typename... Args>
+    constexpr void Construct(Args &&...args) {
+        if constexpr (kNiche && !std::is_nothrow_constructible_v<T, Args...>) {
+            // NOTE: 生态位模式下新值直接写在哨兵上, 构造函数抛出前可能已经改写了部分成员,
+            // 必须恢复哨兵, 否则 HasValue() 会把半成品当成有值, 析构时再析构一次
+            try {
+                std::construct_at(std::addressof(m_value), std::forward<Args>(args)...);
+            } catch (...) {
+                InitEmpty();
+                throw;
+            }
+        } else {
+            std::construct_at(std::addressof(m_value), std::forward<Args>(args)...);
+        }
+        m_has_value = true;
+    }
+
+    // 空状态: 有生态位时在 m_value 上构造哨兵, 否则 m_has_value 已为 false
+    constexpr void InitEmpty() noexcept {
+        if constexpr (kNiche) {
+            NicheTraits<T>::SetEmpty(std::addressof(m_value));
+        }
+    }
+
+    template <typename Other>
+    constexpr void Assign(Other &&other) {
+        if (HasValue() && other.HasValue()) {
+            m_value = std::forward<Other>(other).m_value;
+        } else if (other.HasValue()) {
+            Construct(std::forward<Other>(other).m_value);
+        } else {
+            Reset();
+        }
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto AndThenImpl(Self &&self, F &&f) {
+        using Result = std::remove_cvref_t<
+            std::invoke_result_t<F, decltype((std::forward<Self>(self).m_value))>>;
+        static_assert(_kIsOptional<Result>, "AndThen 的函数必须返回 Optional");
+        if (self.HasValue()) {
+            return std::invoke(std::forward<F>(f), std::forward<Self>(self).m_value);
+        }
+        return Result{};
+    }
+
+    template <typename Self, typename F>
+    static constexpr auto TransformImpl(Self &&self, F &&f) {
+        using Result = std::remove_cv_t<
+            std::invoke_result_t<F, decltype((std::forward<Self>(self).m_value))>>;
+        if (self.HasValue()) {
+            return Optional<Result>{
+                std::in_place, std::invoke(std::forward<F>(f), std::forward<Self>(self).m_value)};
+        }
+        return Optional<Result>{};
+    }
+
     // 使用union防止T是一个没有默认构造函数的类
     // 则无法使用Optional 的构造函数的初始化列表语句m_value()
     union {
         T m_value;
         nullopt_t m_nullopt;
     };
+    [[no_unique_address]] std::conditional_t<kNiche, _OptionalNicheFlag, bool> m_has_value{false};
 };
 
-}  // namespace cutestl
\ No newline at end of file
+// 比较: 都为空视为相等
+template <typename T, typename U>
+constexpr bool operator==(Optional<T> const &lhs, Optional<U> const &rhs) {
+    if (lhs.HasValue() != rhs.HasValue()) {
+        return false;
+    }
+    return !lhs.HasValue() || *lhs == *rhs;
+}
+
+template <typename T>
+constexpr bool operator==(Optional<T> const &opt, nullopt_t) noexcept {
+    return !opt.HasValue();
+}
+
+template <typename T, typename U>
+    requires(!_kIsOptional<U>)
+constexpr bool operator==(Optional<T> const &opt, U const &value) {
+    return opt.HasValue() && *opt == value;
+}
+
+}  // namespace cutestl
@@ -0,0 +1,4 @@
+#pragma once
+
+#include "_indexed_heap.hpp"
+#include "_priority_queue.hpp"
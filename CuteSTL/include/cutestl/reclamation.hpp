@@ -0,0 +1,4 @@
+#pragma once
+
+#include "_epoch_reclaimer.hpp"
+#include "_hazard_pointer.hpp"
@@ -1,36 +1,79 @@
+#pragma once
+
 #include <atomic>
+#include <cassert>
 #include <compare>
 #include <concepts>
 #include <cstddef>
-#include <functional>
-#include <iostream>
+#include <cstdint>
 #include <memory>
-#include <thread>
+#include <new>
+#include <type_traits>
 #include <utility>
-#include <vector>
+
+#include "_niche.hpp"
+#include "_ref_count.hpp"
+#include "allocator.hpp"
 
 // NOTE: copy-and-swap: 拷贝构造函数 + 交换
 // 1. 对于赋值运算符具有强异常安全保证
 // 2. 不需要检查自赋值
 
+// NOTE: 控制块设计
+// - 控制块按删除器/分配器类型模板化, 删除器直接作为成员保存 (空删除器不占空间)
+// - 引用计数归零时只做一次虚调用 Dispose 销毁对象, 再一次虚调用 Destroy 释放控制块
+// - MakeShared/AllocateShared 把对象与计数放在同一块内存里, 只分配一次
+// - 强引用计数与弱引用计数分开: 强引用归零即销毁对象 (释放它持有的资源),
+//   弱引用归零才释放控制块. 所有强引用合起来只占一个弱引用
+// NOTE: MakeShared 创建的对象与控制块是同一块内存, 对象析构后这块内存要等最后一个 WeakPtr 释放
+// - 计数方式由策略参数 RefCount 决定: 默认 AtomicRefCount 可跨线程共享;
+//   LocalRefCount 用普通整数, 只能在一个线程内使用 (LocalSharedPtr)
+
+namespace cutestl {
+
 // C++20 Concept: 检查 From* 是否可以转换为 To*
 template <typename From, typename To>
 concept PointerConvertible = std::is_convertible_v<From*, To*>;
 
-// 内部控制块结构
-struct ControlBlock {
-    std::atomic<size_t> ref_cnt_{1};      // 引用计数 NOTE: 初始值 1
-    std::function<void(void*)> deleter_;  // 类型擦除删除器
+// 控制块基类: 引用计数 + 销毁接口
+template <typename RefCount>
+class _ControlBlockBase {
+public:
+    _ControlBlockBase() noexcept = default;
+    _ControlBlockBase(_ControlBlockBase const&) = delete;
+    _ControlBlockBase& operator=(_ControlBlockBase const&) = delete;
 
-    // 构造函数，接收一个指针和对应的删除器
-    template <typename U, typename Deleter>
-    ControlBlock(U*, Deleter d) {  // NOTE: 指针类型 U 后面用于转换
-        // 使用 lambda 捕获具体的删除器，并将其包装进 std::function
-        // 无论原始删除器是函数指针还是带状态的函数对象，都可以被正确存储和调用
-        deleter_ = [deleter = std::move(d)](void* ptr_to_delete) {
-            deleter(static_cast<U*>(ptr_to_delete));  // NOTE: 需要强转回原来的类型才能正确析构!
-        };
+    void AddRef() noexcept { use_cnt_.Increment(); }
+
+    void AddWeakRef() noexcept { weak_cnt_.Increment(); }
+
+    // WeakPtr::Lock 使用: 强引用不为 0 时才加一, 返回是否成功
+    bool TryAddRef() noexcept { return use_cnt_.TryIncrement(); }
+
+    void Release() noexcept {
+        if (use_cnt_.Decrement()) {
+            Dispose();
+            WeakRelease();  // 归还所有强引用共同持有的那个弱引用
+        }
+    }
+
+    void WeakRelease() noexcept {
+        if (weak_cnt_.Decrement()) {
+            Destroy();
+        }
     }
+
+    std::size_t UseCount() const noexcept { return use_cnt_.Load(); }
+
+protected:
+    virtual ~_ControlBlockBase() = default;
+
+private:
+    virtual void Dispose() noexcept = 0;  // 销毁被管理的对象
+    virtual void Destroy() noexcept = 0;  // 释放控制块自身
+
+    RefCount use_cnt_{1};   // 强引用计数 NOTE: 初始值 1
+    RefCount weak_cnt_{1};  // 弱引用计数 + 1 (所有强引用共同持有)
 };
 
 // 默认删除器
@@ -39,10 +82,83 @@ struct DefaultDeleter {
     void operator()(T* ptr) const { delete ptr; }
 };
 
+// 对象与控制块分开分配: 从裸指针构造时使用
+// NOTE: 指针类型 U 是构造时的原始静态类型, 保证用正确的类型析构
+template <typename U, typename Deleter, typename RefCount>
+class _ControlBlockPtr final : public _ControlBlockBase<RefCount> {
+public:
+    _ControlBlockPtr(U* ptr, Deleter deleter) noexcept(
+        std::is_nothrow_move_constructible_v<Deleter>)
+        : ptr_(ptr), deleter_(std::move(deleter)) {}
+
+private:
+    void Dispose() noexcept override { deleter_(ptr_); }
+    void Destroy() noexcept override { delete this; }
+
+    U* ptr_;
+    [[no_unique_address]] Deleter deleter_;
+};
+
+// 对象就地放在控制块里: MakeShared/AllocateShared 使用
+// Alloc 是 cutestl 风格的分配器 (Allocate(n)/Deallocate(p, n)), 通过 rebind 分配整个控制块
+template <typename T, typename Alloc, typename RefCount>
+class _ControlBlockInplace final : public _ControlBlockBase<RefCount> {
+public:
+    using BlockAllocator = typename Alloc::template rebind<_ControlBlockInplace>::other;
+
+    template <typename... Args>
+    explicit _ControlBlockInplace(BlockAllocator const& alloc, Args&&... args) : alloc_(alloc) {
+        ::new (static_cast<void*>(storage_)) T(std::forward<Args>(args)...);
+    }
+
+    T* Get() noexcept { return std::launder(reinterpret_cast<T*>(storage_)); }
+
+private:
+    void Dispose() noexcept override { Get()->~T(); }
+
+    void Destroy() noexcept override {
+        BlockAllocator alloc{alloc_};  // NOTE: 先拷出分配器, 析构控制块后再用它释放内存
+        this->~_ControlBlockInplace();
+        alloc.Deallocate(this, 1);
+    }
+
+    [[no_unique_address]] BlockAllocator alloc_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+};
+
+template <typename T, typename RefCount = AtomicRefCount>
+class SharedPtr;
+
+template <typename T, typename RefCount = AtomicRefCount>
+class WeakPtr;
+
+template <typename T, typename RefCount = AtomicRefCount>
+class EnableSharedFromThis;
+
 template <typename T>
+class AtomicSharedPtr;
+
+template <typename T, typename RefCount, typename Alloc, typename... Args>
+SharedPtr<T, RefCount> _AllocateShared(Alloc const& alloc, Args&&... args);
+
+template <typename T, typename RefCount>
 class SharedPtr {
-    template <typename U>
+    template <typename U, typename R>
     friend class SharedPtr;  // 允许所有 SharedPtr<U> 访问私有成员
+
+    template <typename U, typename R>
+    friend class WeakPtr;
+
+    template <typename U>
+    friend class AtomicSharedPtr;
+
+    template <typename U, typename R, typename Alloc, typename... Args>
+    friend SharedPtr<U, R> _AllocateShared(Alloc const& alloc, Args&&... args);
+
+    friend struct NicheTraits<SharedPtr>;
+
+    using ControlBlock = _ControlBlockBase<RefCount>;
+
 public:
     // 默认构造函数，创建一个空的 SharedPtr
     SharedPtr() noexcept = default;
@@ -53,26 +169,43 @@ public:
     // 从原始指针构造 SharedPtr (默认删除器)
     // DefaultDeleter 模板参数使用原始的静态类型 U
     template <PointerConvertible<T> U>  // NOTE: 写法含义: U 可以隐式转换为 T
-    explicit SharedPtr(U* ptr)
-        : p_(ptr), cb_(ptr ? new ControlBlock{ptr, DefaultDeleter<U>{}} : nullptr) {}
+    explicit SharedPtr(U* ptr) : SharedPtr(ptr, DefaultDeleter<U>{}) {}
 
     // 从原始指针和自定义删除器构造
-    template <PointerConvertible<T> U, typename Deleter>
-    SharedPtr(U* ptr, Deleter deleter)
-        : p_(ptr), cb_(ptr ? new ControlBlock{ptr, std::move(deleter)} : nullptr) {}
+    template <PointerConvertible<T> U, std::invocable<U*> Deleter>
+    SharedPtr(U* ptr, Deleter deleter) : p_(ptr) {
+        if (!ptr) {
+            return;
+        }
+        try {
+            cb_ = new _ControlBlockPtr<U, Deleter, RefCount>{ptr, std::move(deleter)};
+        } catch (...) {
+            deleter(ptr);  // HACK: 控制块分配失败时仍要释放对象, 否则泄漏
+            throw;
+        }
+        EnableWeakThis(ptr);
+    }
+
+    // 从 WeakPtr 构造, 对象已经销毁时抛出 std::bad_weak_ptr
+    template <PointerConvertible<T> U>
+    explicit SharedPtr(const WeakPtr<U, RefCount>& weak) : p_(weak.p_), cb_(weak.cb_) {
+        if (!cb_ || !cb_->TryAddRef()) {
+            throw std::bad_weak_ptr{};
+        }
+    }
 
     // 拷贝构造函数
     SharedPtr(const SharedPtr& other) noexcept : p_(other.p_), cb_(other.cb_) {
         if (cb_) {
-            cb_->ref_cnt_.fetch_add(1, std::memory_order_relaxed);
+            cb_->AddRef();
         }
     }
 
     // 拷贝构造函数 (模板化)
     template <PointerConvertible<T> U>
-    SharedPtr(const SharedPtr<U>& other) noexcept : p_(other.p_), cb_(other.cb_) {
+    SharedPtr(const SharedPtr<U, RefCount>& other) noexcept : p_(other.p_), cb_(other.cb_) {
         if (cb_) {
-            cb_->ref_cnt_.fetch_add(1, std::memory_order_relaxed);
+            cb_->AddRef();
         }
     }
 
@@ -84,7 +217,7 @@ public:
 
     // 移动构造函数 (模板化)
     template <PointerConvertible<T> U>
-    SharedPtr(SharedPtr<U>&& other) noexcept {
+    SharedPtr(SharedPtr<U, RefCount>&& other) noexcept {
         p_ = std::exchange(other.p_, nullptr);
         cb_ = std::exchange(other.cb_, nullptr);
     }
@@ -100,7 +233,7 @@ public:
 
     // 拷贝赋值运算符 (模板化)
     template <PointerConvertible<T> U>
-    SharedPtr& operator=(const SharedPtr<U>& other) noexcept {
+    SharedPtr& operator=(const SharedPtr<U, RefCount>& other) noexcept {
         SharedPtr{other}.Swap(*this);
         return *this;
     }
@@ -113,7 +246,7 @@ public:
 
     // 移动赋值运算符 (模板化)
     template <PointerConvertible<T> U>
-    SharedPtr& operator=(SharedPtr<U>&& other) noexcept {
+    SharedPtr& operator=(SharedPtr<U, RefCount>&& other) noexcept {
         SharedPtr{std::move(other)}.Swap(*this);
         return *this;
     }
@@ -147,9 +280,7 @@ public:
     T* operator->() const noexcept { return p_; }
 
     // 获取引用计数
-    size_t UseCount() const noexcept {
-        return cb_ ? cb_->ref_cnt_.load(std::memory_order_acquire) : 0;
-    }
+    size_t UseCount() const noexcept { return cb_ ? cb_->UseCount() : 0; }
 
     // 检查是否拥有对象
     explicit operator bool() const noexcept { return p_ != nullptr; }
@@ -161,22 +292,383 @@ public:
     // 与 nullptr 的比较
     auto operator<=>(std::nullptr_t) const noexcept { return p_ <=> nullptr; }
 
+    // NOTE: 自定义的 <=> 不会生成 ==, 需要单独提供
+    bool operator==(const SharedPtr& other) const noexcept { return p_ == other.p_; }
+    bool operator==(std::nullptr_t) const noexcept { return p_ == nullptr; }
+
 private:
-    // NOTE: 经典 Release !!
-    void Release() {
+    // 接管已经持有一个引用的控制块
+    SharedPtr(T* ptr, ControlBlock* cb) noexcept : p_(ptr), cb_(cb) {}
+
+    // 对象继承了 EnableSharedFromThis 时, 让它记住自己的控制块
+    template <typename U>
+    void EnableWeakThis(U* ptr) noexcept {
+        if constexpr (requires { typename U::_SharedFromThisType; }) {
+            using Base = EnableSharedFromThis<typename U::_SharedFromThisType, RefCount>;
+            if constexpr (std::is_convertible_v<U*, Base const*>) {
+                static_cast<Base const*>(ptr)->AcceptOwner(
+                    const_cast<std::remove_cv_t<U>*>(ptr), cb_);
+            }
+        }
+    }
+
+    void Release() noexcept {
         if (!cb_) {
             return;
         }
-        // fetch_sub 和 acquire-release 语义
-        if (cb_->ref_cnt_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-            cb_->deleter_(p_);
-            delete cb_;
+        cb_->Release();
+        p_ = nullptr;
+        cb_ = nullptr;
+    }
+
+private:
+    T* p_{nullptr};
+    ControlBlock* cb_{nullptr};
+};
+
+// 弱引用: 不阻止对象销毁, 通过 Lock() 尝试获得强引用
+template <typename T, typename RefCount>
+class WeakPtr {
+    template <typename U, typename R>
+    friend class WeakPtr;
+
+    template <typename U, typename R>
+    friend class SharedPtr;
+
+    template <typename U, typename R>
+    friend class EnableSharedFromThis;
+
+    using ControlBlock = _ControlBlockBase<RefCount>;
+
+public:
+    WeakPtr() noexcept = default;
+
+    WeakPtr(const WeakPtr& other) noexcept : p_(other.p_), cb_(other.cb_) {
+        if (cb_) {
+            cb_->AddWeakRef();
+        }
+    }
+
+    template <PointerConvertible<T> U>
+    WeakPtr(const WeakPtr<U, RefCount>& other) noexcept : p_(other.p_), cb_(other.cb_) {
+        if (cb_) {
+            cb_->AddWeakRef();
+        }
+    }
+
+    template <PointerConvertible<T> U>
+    WeakPtr(const SharedPtr<U, RefCount>& shared) noexcept : p_(shared.p_), cb_(shared.cb_) {
+        if (cb_) {
+            cb_->AddWeakRef();
+        }
+    }
+
+    WeakPtr(WeakPtr&& other) noexcept {
+        p_ = std::exchange(other.p_, nullptr);
+        cb_ = std::exchange(other.cb_, nullptr);
+    }
+
+    template <PointerConvertible<T> U>
+    WeakPtr(WeakPtr<U, RefCount>&& other) noexcept {
+        p_ = std::exchange(other.p_, nullptr);
+        cb_ = std::exchange(other.cb_, nullptr);
+    }
+
+    ~WeakPtr() { Reset(); }
+
+    WeakPtr& operator=(const WeakPtr& other) noexcept {
+        WeakPtr{other}.Swap(*this);
+        return *this;
+    }
+
+    WeakPtr& operator=(WeakPtr&& other) noexcept {
+        WeakPtr{std::move(other)}.Swap(*this);
+        return *this;
+    }
+
+    template <PointerConvertible<T> U>
+    WeakPtr& operator=(const SharedPtr<U, RefCount>& shared) noexcept {
+        WeakPtr{shared}.Swap(*this);
+        return *this;
+    }
+
+    void Reset() noexcept {
+        if (cb_) {
+            cb_->WeakRelease();
         }
         p_ = nullptr;
         cb_ = nullptr;
     }
 
+    void Swap(WeakPtr& other) noexcept {
+        std::swap(p_, other.p_);
+        std::swap(cb_, other.cb_);
+    }
+
+    std::size_t UseCount() const noexcept { return cb_ ? cb_->UseCount() : 0; }
+
+    bool Expired() const noexcept { return UseCount() == 0; }
+
+    // 无锁地尝试获得强引用, 对象已销毁时返回空 SharedPtr
+    SharedPtr<T, RefCount> Lock() const noexcept {
+        if (cb_ && cb_->TryAddRef()) {
+            return SharedPtr<T, RefCount>{p_, cb_};
+        }
+        return {};
+    }
+
 private:
     T* p_{nullptr};
     ControlBlock* cb_{nullptr};
 };
+
+// 继承 EnableSharedFromThis<T> 的对象被 SharedPtr 管理后, 可以在成员函数里拿到指向自己的 SharedPtr
+//   struct Session : EnableSharedFromThis<Session> {
+//       void Start() { pool.Submit([self = SharedFromThis()] { ... }); }
+//   };
+// NOTE: RefCount 需与管理对象的 SharedPtr 一致, 例如 LocalSharedPtr 管理的对象继承
+// EnableSharedFromThis<T, LocalRefCount>
+template <typename T, typename RefCount>
+class EnableSharedFromThis {
+    template <typename U, typename R>
+    friend class SharedPtr;
+
+public:
+    using _SharedFromThisType = T;  // SharedPtr 据此检测基类
+
+    // 对象未被 SharedPtr 管理时抛出 std::bad_weak_ptr
+    SharedPtr<T, RefCount> SharedFromThis() { return SharedPtr<T, RefCount>{weak_this_}; }
+    SharedPtr<T const, RefCount> SharedFromThis() const {
+        return SharedPtr<T const, RefCount>{weak_this_};
+    }
+
+    WeakPtr<T, RefCount> WeakFromThis() noexcept { return weak_this_; }
+    WeakPtr<T const, RefCount> WeakFromThis() const noexcept { return weak_this_; }
+
+protected:
+    EnableSharedFromThis() noexcept = default;
+
+    // NOTE: 拷贝对象不拷贝 weak_this_, 副本属于另外的所有者
+    EnableSharedFromThis(EnableSharedFromThis const&) noexcept {}
+    EnableSharedFromThis& operator=(EnableSharedFromThis const&) noexcept { return *this; }
+
+    ~EnableSharedFromThis() = default;
+
+private:
+    // 只有第一个所有者生效
+    void AcceptOwner(T* ptr, _ControlBlockBase<RefCount>* cb) const noexcept {
+        if (weak_this_.Expired()) {
+            WeakPtr<T, RefCount> weak;
+            weak.p_ = ptr;
+            weak.cb_ = cb;
+            cb->AddWeakRef();
+            weak_this_ = std::move(weak);
+        }
+    }
+
+    mutable WeakPtr<T, RefCount> weak_this_;
+};
+
+// 生态位: 哨兵是没有控制块、指针为 _NichePointer 的 SharedPtr (析构也是空操作)
+template <typename T, typename RefCount>
+struct NicheTraits<SharedPtr<T, RefCount>> {
+    using Ptr = SharedPtr<T, RefCount>;
+
+    static void SetEmpty(Ptr* storage) noexcept {
+        ::new (static_cast<void*>(storage)) Ptr(_NichePointer<T*>(), nullptr);
+    }
+
+    static bool IsEmpty(Ptr const& value) noexcept { return value.p_ == _NichePointer<T*>(); }
+};
+
+template <typename T>
+using LocalSharedPtr = SharedPtr<T, LocalRefCount>;
+
+template <typename T>
+using LocalWeakPtr = WeakPtr<T, LocalRefCount>;
+
+// 用分配器 alloc 一次分配对象与控制块
+template <typename T, typename RefCount, typename Alloc, typename... Args>
+SharedPtr<T, RefCount> _AllocateShared(Alloc const& alloc, Args&&... args) {
+    using Block = _ControlBlockInplace<T, Alloc, RefCount>;
+    typename Block::BlockAllocator block_alloc{alloc};
+    Block* block = block_alloc.Allocate(1);
+    try {
+        ::new (static_cast<void*>(block)) Block(block_alloc, std::forward<Args>(args)...);
+    } catch (...) {
+        block_alloc.Deallocate(block, 1);  // T 的构造函数抛异常时归还内存
+        throw;
+    }
+    SharedPtr<T, RefCount> result{block->Get(), block};
+    result.EnableWeakThis(block->Get());
+    return result;
+}
+
+template <typename T, typename Alloc, typename... Args>
+SharedPtr<T> AllocateShared(Alloc const& alloc, Args&&... args) {
+    return _AllocateShared<T, AtomicRefCount>(alloc, std::forward<Args>(args)...);
+}
+
+// 对象与引用计数只分配一次
+template <typename T, typename... Args>
+SharedPtr<T> MakeShared(Args&&... args) {
+    return _AllocateShared<T, AtomicRefCount>(Allocator<T>{}, std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc, typename... Args>
+LocalSharedPtr<T> AllocateLocalShared(Alloc const& alloc, Args&&... args) {
+    return _AllocateShared<T, LocalRefCount>(alloc, std::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+LocalSharedPtr<T> MakeLocalShared(Args&&... args) {
+    return _AllocateShared<T, LocalRefCount>(Allocator<T>{}, std::forward<Args>(args)...);
+}
+
+// 可以被多个线程同时读写的 SharedPtr, 适合读多写少的配置/路由表快照:
+//   AtomicSharedPtr<Config> config{MakeShared<Config>()};
+//   SharedPtr<Config> snapshot = config.Load();       // 热路径, 无锁
+//   config.Store(MakeShared<Config>(new_settings));   // 后台线程偶尔替换
+//
+// NOTE: 分离引用计数 (split reference count)
+// - SharedPtr 有两个指针宽, 无法直接原子地读写, 所以放进堆上的 Holder 里, 只原子地保存 Holder 指针
+// - 64 位字的低 48 位是 Holder 指针, 高 16 位是"借用计数": 正在读取该 Holder 的线程数
+// - Load: fetch_add 借用 -> 拷贝 Holder 里的 SharedPtr -> CAS 归还借用 (字没变时)
+// - Store: exchange 换上新 Holder, 把旧字里的借用计数转移到旧 Holder 的 refs_ 上;
+//   之后归还借用的读者发现字已经变了, 改为递减旧 Holder 的 refs_, 减到 0 的线程负责释放
+// HACK: 依赖用户态地址不超过 48 位 (x86-64 / AArch64); 同时进行中的 Load 不能超过 65535 个
+template <typename T>
+class AtomicSharedPtr {
+public:
+    AtomicSharedPtr() noexcept = default;
+
+    explicit AtomicSharedPtr(SharedPtr<T> desired) : word_(Pack(MakeHolder(std::move(desired)))) {}
+
+    AtomicSharedPtr(AtomicSharedPtr const&) = delete;
+    AtomicSharedPtr& operator=(AtomicSharedPtr const&) = delete;
+
+    ~AtomicSharedPtr() {
+        std::uint64_t word = word_.load(std::memory_order_acquire);
+        ReleaseHolder(Unpack(word), Borrowed(word));
+    }
+
+    SharedPtr<T> Load() const noexcept {
+        Holder* holder = Borrow();
+        SharedPtr<T> result = holder ? holder->value_ : SharedPtr<T>{};
+        GiveBack(holder);
+        return result;
+    }
+
+    void Store(SharedPtr<T> desired) { (void)Exchange(std::move(desired)); }
+
+    SharedPtr<T> Exchange(SharedPtr<T> desired) {
+        Holder* fresh = MakeHolder(std::move(desired));
+        std::uint64_t old = word_.exchange(Pack(fresh), std::memory_order_acq_rel);
+        Holder* holder = Unpack(old);
+        // NOTE: 其他读者可能仍在拷贝 holder->value_, 只能拷贝不能移走
+        SharedPtr<T> result = holder ? holder->value_ : SharedPtr<T>{};
+        ReleaseHolder(holder, Borrowed(old));
+        return result;
+    }
+
+    // 当前值与 expected 指向同一对象 (同一控制块) 时替换为 desired 并返回 true;
+    // 否则把当前值写入 expected 并返回 false
+    bool CompareExchange(SharedPtr<T>& expected, SharedPtr<T> desired) {
+        Holder* fresh = nullptr;
+        while (true) {
+            Holder* holder = Borrow();
+            SharedPtr<T> const* current = holder ? &holder->value_ : nullptr;
+            bool same = current ? current->p_ == expected.p_ && current->cb_ == expected.cb_
+                                : expected.cb_ == nullptr;
+            if (!same) {
+                expected = current ? *current : SharedPtr<T>{};
+                GiveBack(holder);
+                ReleaseHolder(fresh, 0);
+                return false;
+            }
+            if (!fresh) {
+                fresh = MakeHolder(std::move(desired));
+            }
+            std::uint64_t word = word_.load(std::memory_order_relaxed);
+            while (Unpack(word) == holder) {
+                if (word_.compare_exchange_weak(word, Pack(fresh), std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+                    // 换下的字里包含本线程的借用, 顺便归还
+                    ReleaseHolder(holder, Borrowed(word) - 1);
+                    return true;
+                }
+            }
+            GiveBack(holder);  // 期间被其他线程替换, 重新比较
+        }
+    }
+
+    static constexpr bool IsLockFree() noexcept { return true; }
+
+private:
+    static_assert(sizeof(void*) == 8, "AtomicSharedPtr 需要 64 位平台");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    static constexpr int kPointerBits = 48;
+    static constexpr std::uint64_t kPointerMask = (std::uint64_t{1} << kPointerBits) - 1;
+    static constexpr std::uint64_t kOneBorrow = std::uint64_t{1} << kPointerBits;
+    // NOTE: refs_ 的初始偏置, 大于借用计数上限, 保证在 Store 转移借用计数前 refs_ 不会减到 0
+    static constexpr std::int64_t kHolderBias = std::int64_t{1} << 32;
+
+    struct Holder {
+        SharedPtr<T> value_;
+        std::atomic<std::int64_t> refs_{kHolderBias};
+    };
+
+    // 空 SharedPtr 不分配 Holder, 用空指针表示
+    static Holder* MakeHolder(SharedPtr<T> value) {
+        return value.cb_ ? new Holder{std::move(value)} : nullptr;
+    }
+
+    static std::uint64_t Pack(Holder* holder) noexcept {
+        auto bits = reinterpret_cast<std::uintptr_t>(holder);
+        assert((bits & ~kPointerMask) == 0 && "指针超过 48 位");
+        return bits;
+    }
+
+    static Holder* Unpack(std::uint64_t word) noexcept {
+        return reinterpret_cast<Holder*>(static_cast<std::uintptr_t>(word & kPointerMask));
+    }
+
+    static std::int64_t Borrowed(std::uint64_t word) noexcept {
+        return static_cast<std::int64_t>(word >> kPointerBits);
+    }
+
+    // 借用当前 Holder: 借用期间它不会被释放
+    Holder* Borrow() const noexcept {
+        return Unpack(word_.fetch_add(kOneBorrow, std::memory_order_acquire));
+    }
+
+    // 归还借用: 字没变则直接减借用计数, 否则借用已转移到 Holder 上
+    void GiveBack(Holder* holder) const noexcept {
+        std::uint64_t word = word_.load(std::memory_order_relaxed);
+        while (Unpack(word) == holder) {
+            if (word_.compare_exchange_weak(word, word - kOneBorrow, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+                return;
+            }
+        }
+        if (holder && holder->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete holder;
+        }
+    }
+
+    // 从字上换下 holder 时调用: 撤掉初始偏置, 并计入仍在读取的 borrowed 个读者
+    static void ReleaseHolder(Holder* holder, std::int64_t borrowed) noexcept {
+        if (!holder) {
+            return;
+        }
+        std::int64_t delta = borrowed - kHolderBias;
+        if (holder->refs_.fetch_add(delta, std::memory_order_acq_rel) + delta == 0) {
+            delete holder;
+        }
+    }
+
+    mutable std::atomic<std::uint64_t> word_{0};
+};
+
+}  // namespace cutestl
@@ -0,0 +1,399 @@
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "_hardware.hpp"
+#include "allocator.hpp"
+
+// 列式存储的 Vector (structure of arrays): 每个字段各自存放在一个连续数组里, 共用一个 size / capacity
+// 用法:
+//   SoaVector<std::uint64_t, double, std::uint32_t> orders;   // id, price, qty
+//   orders.EmplaceBack(id, price, qty);
+//   auto [order_id, order_price, order_qty] = orders[i];       // 行代理: 字段引用的 tuple
+//   double sum = 0;
+//   for (double price : orders.Column<1>()) { sum += price; }  // 只扫描需要的列
+//
+// NOTE: 为什么按列存
+// - 一条记录有很多字段而热循环只读其中几个时, Vector<Struct> 取进来的每条缓存行大部分是无用字段;
+//   按列存后扫描一列只读这一列, 缓存与内存带宽全部用在有效数据上, 也更容易被编译器向量化
+// - 每一列按缓存行 (64 字节) 对齐分配
+// NOTE: 解引用迭代器 / operator[] 得到的是 tuple<Ts&...> 代理对象, 可以结构化绑定, 也可以整体赋值;
+// 它不是某个 struct 的引用, 不能取地址长期保存
+// NOTE: C++20 的 std::sort 等需要交换元素的算法不支持这种代理迭代器; 按列排序时先排下标再重排
+// NOTE: 扩容策略与 Vector 相同 (2 倍), 所有列一起扩容; 扩容会让迭代器和 Column() 返回的 span 失效
+
+namespace cutestl {
+
+template <bool kConst, typename... Ts>
+class _SoaIterator {
+    template <bool C, typename... Us>
+    friend class _SoaIterator;
+
+    template <typename... Us>
+    friend class SoaVector;
+
+    using Columns = std::tuple<std::conditional_t<kConst, Ts const*, Ts*>...>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = std::tuple<Ts...>;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<std::conditional_t<kConst, Ts const&, Ts&>...>;
+    using pointer = void;  // tuple 没有可以用 -> 访问的成员
+
+    _SoaIterator() noexcept = default;
+    _SoaIterator(_SoaIterator const&) noexcept = default;
+    _SoaIterator& operator=(_SoaIterator const&) noexcept = default;
+
+    // iterator 可以隐式转换为 const_iterator
+    _SoaIterator(_SoaIterator<false, Ts...> const& other) noexcept
+        requires kConst
+        : columns_(other.columns_), index_(other.index_) {}
+
+    reference operator*() const noexcept {
+        return std::apply([this](auto*... columns) { return reference{columns[index_]...}; },
+                          columns_);
+    }
+    reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+    _SoaIterator& operator++() noexcept { return *this += 1; }
+    _SoaIterator& operator--() noexcept { return *this -= 1; }
+
+    _SoaIterator operator++(int) noexcept {
+        _SoaIterator tmp = *this;
+        ++*this;
+        return tmp;
+    }
+
+    _SoaIterator operator--(int) noexcept {
+        _SoaIterator tmp = *this;
+        --*this;
+        return tmp;
+    }
+
+    _SoaIterator& operator+=(difference_type n) noexcept {
+        index_ += n;
+        return *this;
+    }
+
+    _SoaIterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend _SoaIterator operator+(_SoaIterator it, difference_type n) noexcept { return it += n; }
+    friend _SoaIterator operator+(difference_type n, _SoaIterator it) noexcept { return it += n; }
+    friend _SoaIterator operator-(_SoaIterator it, difference_type n) noexcept { return it -= n; }
+    friend difference_type operator-(_SoaIterator const& lhs, _SoaIterator const& rhs) noexcept {
+        return lhs.index_ - rhs.index_;
+    }
+
+    bool operator==(_SoaIterator const& other) const noexcept { return index_ == other.index_; }
+    auto operator<=>(_SoaIterator const& other) const noexcept { return index_ <=> other.index_; }
+
+private:
+    _SoaIterator(Columns const& columns, difference_type index) noexcept
+        : columns_(columns), index_(index) {}
+
+    Columns columns_{};
+    difference_type index_{0};
+};
+
+template <typename... Ts>
+class SoaVector {
+    static_assert(sizeof...(Ts) > 0, "SoaVector 至少要有一列");
+
+    using Columns = std::tuple<Ts*...>;
+    using Indices = std::index_sequence_for<Ts...>;
+
+    // 每列按缓存行对齐 (对齐要求更大的类型按它自己的)
+    template <typename T>
+    using ColumnAlloc = AlignedAllocator<T, std::max(kCacheLineSize, alignof(T))>;
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::tuple<Ts&...>;
+    using const_reference = std::tuple<Ts const&...>;
+    using iterator = _SoaIterator<false, Ts...>;
+    using const_iterator = _SoaIterator<true, Ts...>;
+
+    template <std::size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+    static constexpr size_type kColumns = sizeof...(Ts);
+
+public:
+    SoaVector() = default;
+
+    // n 行, 每个字段值初始化
+    explicit SoaVector(size_type n) { Resize(n); }
+
+    SoaVector(std::initializer_list<value_type> init) {
+        Reserve(init.size());
+        for (value_type const& row : init) {
+            PushBack(row);
+        }
+    }
+
+    SoaVector(SoaVector const& other) {
+        Reserve(other.size_);
+        for (size_type i = 0; i < other.size_; ++i) {
+            std::apply([this](Ts const&... fields) { EmplaceBack(fields...); }, other[i]);
+        }
+    }
+
+    SoaVector(SoaVector&& other) noexcept
+        : columns_(std::exchange(other.columns_, Columns{})),
+          size_(std::exchange(other.size_, 0)),
+          capacity_(std::exchange(other.capacity_, 0)) {}
+
+    SoaVector& operator=(SoaVector const& other) {
+        if (this != &other) {
+            SoaVector tmp{other};
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    SoaVector& operator=(SoaVector&& other) noexcept {
+        if (this != &other) {
+            SoaVector tmp{std::move(other)};
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    ~SoaVector() {
+        Clear();
+        DeallocateColumns(columns_, capacity_);
+    }
+
+public:
+    size_type Size() const noexcept { return size_; }
+
+    size_type Capacity() const noexcept { return capacity_; }
+
+    bool Empty() const noexcept { return size_ == 0; }
+
+    reference operator[](size_type i) noexcept { return *(begin() + i); }
+
+    const_reference operator[](size_type i) const noexcept { return *(begin() + i); }
+
+    reference At(size_type i) {
+        if (i >= size_) {
+            throw std::out_of_range("SoaVector::At");
+        }
+        return (*this)[i];
+    }
+
+    const_reference At(size_type i) const {
+        if (i >= size_) {
+            throw std::out_of_range("SoaVector::At");
+        }
+        return (*this)[i];
+    }
+
+    reference Front() noexcept { return (*this)[0]; }
+
+    const_reference Front() const noexcept { return (*this)[0]; }
+
+    reference Back() noexcept { return (*this)[size_ - 1]; }
+
+    const_reference Back() const noexcept { return (*this)[size_ - 1]; }
+
+    // 第 I 列的连续视图, 热循环应直接扫描它
+    template <std::size_t I>
+    std::span<column_type<I>> Column() noexcept {
+        return {std::get<I>(columns_), size_};
+    }
+
+    template <std::size_t I>
+    std::span<column_type<I> const> Column() const noexcept {
+        return {std::get<I>(columns_), size_};
+    }
+
+public:
+    iterator begin() noexcept { return iterator{columns_, 0}; }
+    const_iterator begin() const noexcept { return const_iterator{columns_, 0}; }
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() noexcept { return iterator{columns_, static_cast<difference_type>(size_)}; }
+    const_iterator end() const noexcept {
+        return const_iterator{columns_, static_cast<difference_type>(size_)};
+    }
+    const_iterator cend() const noexcept { return end(); }
+
+public:
+    void Reserve(size_type n) {
+        if (n > capacity_) {
+            Relocate(n, [](Columns const&) {});
+        }
+    }
+
+    // 新增的行每个字段值初始化
+    void Resize(size_type n) {
+        if (n <= size_) {
+            DestroyRows(n, size_);
+            size_ = n;
+            return;
+        }
+        Reserve(n);
+        for (; size_ < n; ++size_) {
+            ConstructRow(columns_, size_);
+        }
+    }
+
+    void Clear() noexcept {
+        DestroyRows(0, size_);
+        size_ = 0;
+    }
+
+    void Swap(SoaVector& other) noexcept {
+        std::swap(columns_, other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    // 每个实参构造对应的一列
+    template <typename... Args>
+        requires(sizeof...(Args) == kColumns)
+    reference EmplaceBack(Args&&... args) {
+        if (size_ == capacity_) {
+            // NOTE: 先在新内存里构造新行再搬移旧元素, 实参引用自身元素 (v.EmplaceBack(v[0]...)) 也安全
+            Relocate(std::max(2 * size_, size_ + 1), [&](Columns const& fresh) {
+                ConstructRow(fresh, size_, std::forward<Args>(args)...);
+            });
+        } else {
+            ConstructRow(columns_, size_, std::forward<Args>(args)...);
+        }
+        ++size_;
+        return Back();
+    }
+
+    void PushBack(value_type const& row) {
+        std::apply([this](Ts const&... fields) { EmplaceBack(fields...); }, row);
+    }
+
+    void PushBack(value_type&& row) {
+        std::apply([this](Ts&... fields) { EmplaceBack(std::move(fields)...); }, row);
+    }
+
+    void PopBack() noexcept {
+        DestroyRows(size_ - 1, size_);
+        --size_;
+    }
+
+    // 保序删除, 后面的行逐列前移; 返回指向原来下一行的迭代器
+    iterator Erase(const_iterator pos) {
+        auto index = static_cast<size_type>(pos.index_);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((std::move(std::get<Is>(columns_) + index + 1, std::get<Is>(columns_) + size_,
+                        std::get<Is>(columns_) + index)),
+             ...);
+        }(Indices{});
+        PopBack();
+        return begin() + static_cast<difference_type>(index);
+    }
+
+    // 不保序删除: 用最后一行填补, O(1)
+    void SwapErase(size_type index) {
+        if (index + 1 != size_) {
+            [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                ((std::get<Is>(columns_)[index] = std::move(std::get<Is>(columns_)[size_ - 1])),
+                 ...);
+            }(Indices{});
+        }
+        PopBack();
+    }
+
+private:
+    // 在 columns 的第 index 行逐列构造; 没有实参时值初始化; 某一列抛出异常时析构已构造的列
+    template <typename... Args>
+    static void ConstructRow(Columns const& columns, size_type index, Args&&... args) {
+        auto fields = std::forward_as_tuple(std::forward<Args>(args)...);
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::size_t built = 0;
+            try {
+                ((ConstructField<Is>(std::get<Is>(columns) + index, fields), ++built), ...);
+            } catch (...) {
+                ((Is < built ? std::destroy_at(std::get<Is>(columns) + index) : void()), ...);
+                throw;
+            }
+        }(Indices{});
+    }
+
+    template <std::size_t I, typename T, typename Fields>
+    static void ConstructField(T* p, Fields& fields) {
+        if constexpr (std::tuple_size_v<Fields> == 0) {
+            std::construct_at(p);
+        } else {
+            std::construct_at(p, std::get<I>(std::move(fields)));
+        }
+    }
+
+    void DestroyRows(size_type first, size_type last) noexcept {
+        std::apply([&](Ts*... columns) { (std::destroy(columns + first, columns + last), ...); },
+                   columns_);
+    }
+
+    // 所有列一起换到容量为 capacity 的新内存; fill 在搬移旧元素之前往新内存里构造新行,
+    // 抛出异常时新内存全部释放, 原内容不变
+    template <typename Fill>
+    void Relocate(size_type capacity, Fill&& fill) {
+        Columns fresh = AllocateColumns(capacity);
+        try {
+            fill(fresh);
+        } catch (...) {
+            DeallocateColumns(fresh, capacity);
+            throw;
+        }
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            ((std::uninitialized_move(std::get<Is>(columns_), std::get<Is>(columns_) + size_,
+                                      std::get<Is>(fresh))),
+             ...);
+        }(Indices{});
+        DestroyRows(0, size_);
+        DeallocateColumns(columns_, capacity_);
+        columns_ = fresh;
+        capacity_ = capacity;
+    }
+
+    static Columns AllocateColumns(size_type capacity) {
+        Columns columns{};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+            std::size_t allocated = 0;
+            try {
+                ((std::get<Is>(columns) = ColumnAlloc<Ts>::Allocate(capacity), ++allocated), ...);
+            } catch (...) {
+                ((Is < allocated ? ColumnAlloc<Ts>::Deallocate(std::get<Is>(columns), capacity)
+                                 : void()),
+                 ...);
+                throw;
+            }
+        }(Indices{});
+        return columns;
+    }
+
+    static void DeallocateColumns(Columns const& columns, size_type capacity) noexcept {
+        if (capacity == 0) {
+            return;
+        }
+        std::apply([&](Ts*... p) { (ColumnAlloc<Ts>::Deallocate(p, capacity), ...); }, columns);
+    }
+
+    Columns columns_{};
+    size_type size_{0};
+    size_type capacity_{0};
+};
+
+}  // namespace cutestl
@@ -3,7 +3,10 @@
 #include <algorithm>  // for std::swap, std::min, std::max
 #include <cstring>    // for std::strlen, std::memcpy, std::strcmp
 #include <iostream>   // for std::istream, std::ostream
-#include <utility>    // for std::move
+#include <string_view>
+#include <utility>  // for std::move
+
+#include "_hash.hpp"
 
 class String {
 public:
@@ -95,6 +98,9 @@ public:
     // 返回一个指向以空字符结尾的C风格字符串的指针
     const char* c_str() const noexcept { return data_ ? data_ : ""; }
 
+    // 隐式转换为 std::string_view (与 std::string 一致), 用于哈希容器的异构查找
+    operator std::string_view() const noexcept { return {c_str(), size_}; }
+
     // 6. 修改器 (Modifiers)
 
     // 拼接另一个MyString
@@ -202,3 +208,10 @@ inline std::ostream& operator<<(std::ostream& os, const String& s) {
 
 // 非成员swap函数
 inline void swap(String& a, String& b) noexcept { a.swap(b); }
+
+// 哈希容器支持: 以 String 为键时可以用 std::string_view 透明查找
+template <>
+struct cutestl::Hash<String> : cutestl::_StringHash {};
+
+template <>
+struct cutestl::EqualTo<String> : cutestl::_StringEqual {};
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "_move_only_function.hpp"
+#include "thread_pool.hpp"
+#include "unique_ptr.hpp"
+
+// 分层时间轮: 大量定时器的 O(1) 插入与取消, 到期回调交给 ThreadPool 执行
+// 用法:
+//   TimerWheel wheel{{.pool = &pool}};
+//   auto handle = wheel.ScheduleAfter(std::chrono::seconds{30}, [conn] { conn->Timeout(); });
+//   wheel.Cancel(handle);  // 收到响应, 取消超时
+//
+// NOTE: 结构 (与早期 Linux 内核定时器相同)
+// - 时间按 tick (默认 1 ms) 离散化, 4 层各 256 个槽位, 覆盖 2^32 个 tick (1 ms 时约 49 天);
+//   更远的定时器先放在最高层, 降级时再按真实到期时间重新放置
+// - 第 0 层一个槽位对应一个 tick; 第 k 层一个槽位对应 256^k 个 tick,
+//   第 0 层转完一圈时把上一层的当前槽位 "降级" (cascade) 到下层
+// - 每个槽位是侵入式双向链表, 插入/取消都是 O(1), 不需要像堆那样 O(log n) 调整
+// NOTE: 定时器节点从按块分配的对象池里取, 回调存放在 MoveOnlyFunction 的内联缓冲区里,
+// 捕获不超过 3 个指针大小时插入一个定时器没有任何堆分配
+// NOTE: 批量处理 tick
+// - 驱动线程睡到下一个有事件的 tick (非空槽位或降级点), 醒来后一次处理所有已经过去的 tick
+// - 到期的回调在锁外分组提交到线程池, 每组 batch_size 个回调一个任务, 减少线程池队列的锁竞争
+// NOTE: 回调不应抛出异常 (没有调用方可以接收它); 定时器最多晚一个 tick 触发, 不会提前
+// NOTE: 析构时尚未触发的定时器直接丢弃; 线程池已关停时到期的回调也会被丢弃
+
+namespace cutestl {
+
+struct TimerWheelOptions {
+    // 时间精度
+    std::chrono::steady_clock::duration tick = std::chrono::milliseconds{1};
+    // 执行回调的线程池; nullptr 表示直接在驱动线程 (或调用 Advance 的线程) 上执行
+    ThreadPool* pool = nullptr;
+    // 提交到线程池的优先级
+    TaskPriority priority = TaskPriority::kNormal;
+    // 每个线程池任务最多执行的回调个数
+    std::size_t batch_size = 64;
+    // false 表示不启动驱动线程, 由调用方定期调用 Advance()
+    bool start_thread = true;
+};
+
+class TimerWheel {
+    struct Node;
+
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = MoveOnlyFunction<void()>;
+
+    // 取消句柄: 节点被复用后代数不同, 旧句柄的 Cancel 返回 false
+    class Handle {
+    public:
+        Handle() noexcept = default;
+
+        bool operator==(Handle const&) const noexcept = default;
+
+    private:
+        friend class TimerWheel;
+
+        Handle(Node* node, std::uint32_t generation) noexcept
+            : node_(node), generation_(generation) {}
+
+        Node* node_{nullptr};
+        std::uint32_t generation_{0};
+    };
+
+public:
+    explicit TimerWheel(TimerWheelOptions const& options = {})
+        : options_(options), start_(Clock::now()) {
+        if (options_.tick <= Clock::duration::zero()) {
+            throw std::invalid_argument("TimerWheel tick must be positive");
+        }
+        if (options_.batch_size == 0) {
+            options_.batch_size = 1;
+        }
+        if (options_.start_thread) {
+            driver_ = std::thread{[this] { DriverLoop(); }};
+        }
+    }
+
+    TimerWheel(TimerWheel const&) = delete;
+    TimerWheel& operator=(TimerWheel const&) = delete;
+
+    ~TimerWheel() { Stop(); }
+
+public:
+    Handle ScheduleAt(Clock::time_point deadline, Callback callback) {
+        std::uint64_t expire = TickOf(deadline);
+        bool wake;
+        Handle handle;
+        {
+            std::lock_guard lk{mtx_};
+            Node* node = AllocateNode();
+            node->expire_ = expire;
+            node->callback_ = std::move(callback);
+            AddNode(node);
+            ++pending_;
+            handle = Handle{node, node->generation_};
+            // NOTE: 只有比驱动线程预定的醒来时间更早时才需要唤醒它
+            wake = expire < wake_tick_;
+        }
+        if (wake) {
+            cv_.notify_one();
+        }
+        return handle;
+    }
+
+    Handle ScheduleAfter(Clock::duration delay, Callback callback) {
+        Clock::time_point now = Clock::now();
+        // 饱和到 time_point::max(), 避免 delay 很大时溢出
+        Clock::time_point deadline =
+            delay > Clock::time_point::max() - now ? Clock::time_point::max() : now + delay;
+        return ScheduleAt(deadline, std::move(callback));
+    }
+
+    // 返回 true 表示回调不会再执行; 已触发、已取消或句柄为空时返回 false
+    bool Cancel(Handle handle) {
+        Node* node = handle.node_;
+        if (!node) {
+            return false;
+        }
+        Callback callback;  // NOTE: 在锁外销毁回调 (捕获的对象析构可能很慢)
+        {
+            std::lock_guard lk{mtx_};
+            if (node->generation_ != handle.generation_ || !node->pprev_) {
+                return false;
+            }
+            Unlink(node);
+            callback = std::move(node->callback_);
+            FreeNode(node);
+            --pending_;
+        }
+        return true;
+    }
+
+    // 尚未触发的定时器个数
+    std::size_t Pending() const {
+        std::lock_guard lk{mtx_};
+        return pending_;
+    }
+
+    // 处理 now 之前的所有 tick, 执行或提交到期的回调; 返回到期的定时器个数
+    // 驱动线程会自动调用; start_thread = false 时由调用方调用
+    // NOTE: 没有事件的 tick 整段跳过, 长时间没有调用也不会逐个 tick 空转
+    std::size_t Advance(Clock::time_point now) {
+        std::vector<Callback> expired;
+        {
+            std::lock_guard lk{mtx_};
+            std::uint64_t target = now < start_ ? 0 : (now - start_) / options_.tick;
+            while (current_ <= target) {
+                std::uint64_t next = NextEventTick();
+                if (next > target) {
+                    current_ = target + 1;
+                    break;
+                }
+                current_ = next;
+                RunTick(expired);
+                ++current_;
+            }
+        }
+        Dispatch(expired);
+        return expired.size();
+    }
+
+    // 停止驱动线程; 尚未触发的定时器保留, 可以继续手动 Advance
+    void Stop() {
+        {
+            std::lock_guard lk{mtx_};
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        if (driver_.joinable()) {
+            driver_.join();
+        }
+    }
+
+private:
+    static constexpr int kSlotBits = 8;
+    static constexpr std::size_t kSlots = std::size_t{1} << kSlotBits;
+    static constexpr std::uint64_t kSlotMask = kSlots - 1;
+    static constexpr int kLevels = 4;
+    static constexpr std::uint64_t kMaxDelta = (std::uint64_t{1} << (kSlotBits * kLevels)) - 1;
+    static constexpr std::size_t kChunkSize = 1024;  // 对象池每次分配的节点数
+    static constexpr std::uint64_t kNever = std::numeric_limits<std::uint64_t>::max();
+
+    // pprev_ 指向前一个节点的 next_ (或槽位头指针), 删除时不需要知道自己在哪个槽位;
+    // pprev_ 为空表示不在时间轮里 (空闲或已触发)
+    struct Node {
+        Node* next_{nullptr};
+        Node** pprev_{nullptr};
+        std::uint64_t expire_{0};
+        std::uint32_t generation_{0};
+        Callback callback_;
+    };
+
+    // 向上取整: 定时器不会提前触发
+    // NOTE: 不能写成 (elapsed + tick - 1) / tick, deadline 接近 time_point::max() (表示 "永不")
+    // 时有符号加法溢出
+    std::uint64_t TickOf(Clock::time_point deadline) const noexcept {
+        if (deadline <= start_) {
+            return 0;
+        }
+        auto elapsed = (deadline - start_).count();
+        auto tick = options_.tick.count();
+        return static_cast<std::uint64_t>(elapsed / tick + (elapsed % tick != 0));
+    }
+
+    Node* AllocateNode() {
+        if (!free_) {
+            chunks_.push_back(make_unique<Node[]>(kChunkSize));
+            Node* chunk = chunks_.back().get();
+            for (std::size_t i = 0; i < kChunkSize; ++i) {
+                chunk[i].next_ = free_;
+                free_ = &chunk[i];
+            }
+        }
+        Node* node = free_;
+        free_ = node->next_;
+        node->next_ = nullptr;
+        return node;
+    }
+
+    void FreeNode(Node* node) noexcept {
+        ++node->generation_;  // 让旧句柄失效
+        node->pprev_ = nullptr;
+        node->next_ = free_;
+        free_ = node;
+    }
+
+    // 按离当前 tick 的距离选择层级与槽位
+    void AddNode(Node* node) noexcept {
+        std::uint64_t expire = node->expire_ < current_ ? current_ : node->expire_;
+        std::uint64_t delta = expire - current_;
+        if (delta > kMaxDelta) {
+            expire = current_ + kMaxDelta;  // 太远: 先放在最高层, 降级时再按真实到期时间放置
+            delta = kMaxDelta;
+        }
+        int level = 0;
+        while (level + 1 < kLevels && delta >= (std::uint64_t{1} << (kSlotBits * (level + 1)))) {
+            ++level;
+        }
+        std::size_t slot = (expire >> (kSlotBits * level)) & kSlotMask;
+        Link(&wheel_[level][slot], node);
+    }
+
+    static void Link(Node** head, Node* node) noexcept {
+        node->next_ = *head;
+        if (*head) {
+            (*head)->pprev_ = &node->next_;
+        }
+        *head = node;
+        node->pprev_ = head;
+    }
+
+    static void Unlink(Node* node) noexcept {
+        *node->pprev_ = node->next_;
+        if (node->next_) {
+            node->next_->pprev_ = node->pprev_;
+        }
+        node->next_ = nullptr;
+        node->pprev_ = nullptr;
+    }
+
+    // 把 level 层的 slot 槽位整体摘下, 逐个重新放置 (会落到更低的层)
+    void Cascade(int level, std::size_t slot) noexcept {
+        Node* node = std::exchange(wheel_[level][slot], nullptr);
+        while (node) {
+            Node* next = node->next_;
+            node->pprev_ = nullptr;
+            AddNode(node);
+            node = next;
+        }
+    }
+
+    // 处理 current_ 这个 tick: 先降级, 再摘下第 0 层当前槽位里到期的定时器
+    void RunTick(std::vector<Callback>& expired) {
+        for (int level = 1; level < kLevels; ++level) {
+            if (((current_ >> (kSlotBits * (level - 1))) & kSlotMask) != 0) {
+                break;
+            }
+            Cascade(level, (current_ >> (kSlotBits * level)) & kSlotMask);
+        }
+        Node* node = std::exchange(wheel_[0][current_ & kSlotMask], nullptr);
+        while (node) {
+            Node* next = node->next_;
+            node->pprev_ = nullptr;
+            if (node->expire_ > current_) {
+                AddNode(node);  // NOTE: 只有超出覆盖范围而被截断的定时器会走到这里
+            } else {
+                expired.push_back(std::move(node->callback_));
+                FreeNode(node);
+                --pending_;
+            }
+            node = next;
+        }
+    }
+
+    // 从 current_ 起下一个需要处理的 tick: 第 0 层非空槽位的到期点, 或者高层非空槽位的降级点
+    // NOTE: 每层从当前位置起环形扫描一圈, 槽位号比当前位置小的属于下一圈 (插入时绕回);
+    // 各层的候选随槽位单调增大, 超过已找到的最小值就不必再扫
+    std::uint64_t NextEventTick() const noexcept {
+        std::uint64_t best = kNever;
+        for (int level = 0; level < kLevels; ++level) {
+            int shift = kSlotBits * level;
+            // 本层第一个尚未处理的槽位 (高层的降级点必须是 2^shift 的倍数)
+            std::uint64_t first = (current_ + (std::uint64_t{1} << shift) - 1) >> shift;
+            for (std::uint64_t i = 0; i < kSlots; ++i) {
+                std::uint64_t tick = (first + i) << shift;
+                if (tick >= best) {
+                    break;
+                }
+                if (wheel_[level][(first + i) & kSlotMask]) {
+                    best = tick;
+                    break;
+                }
+            }
+        }
+        return best;
+    }
+
+    // 在锁外执行或分组提交到期的回调
+    void Dispatch(std::vector<Callback>& expired) {
+        if (expired.empty()) {
+            return;
+        }
+        if (!options_.pool) {
+            for (Callback& callback : expired) {
+                callback();
+            }
+            return;
+        }
+        for (std::size_t first = 0; first < expired.size(); first += options_.batch_size) {
+            std::size_t last = std::min(expired.size(), first + options_.batch_size);
+            std::vector<Callback> batch;
+            batch.reserve(last - first);
+            for (std::size_t i = first; i < last; ++i) {
+                batch.push_back(std::move(expired[i]));
+            }
+            try {
+                options_.pool->Post(
+                    [batch = std::move(batch)]() mutable {
+                        for (Callback& callback : batch) {
+                            callback();
+                        }
+                    },
+                    options_.priority);
+            } catch (std::runtime_error const&) {  // 线程池已关停, 丢弃
+            }
+        }
+    }
+
+    void DriverLoop() {
+        std::unique_lock lk{mtx_};
+        while (!stopping_) {
+            if (pending_ == 0) {
+                wake_tick_ = kNever;
+                cv_.wait(lk, [this] { return stopping_ || pending_ != 0; });
+                continue;
+            }
+            wake_tick_ = NextEventTick();
+            Clock::time_point due = start_ + options_.tick * static_cast<std::int64_t>(wake_tick_);
+            if (Clock::now() < due) {
+                cv_.wait_until(lk, due);
+                continue;  // 可能被更早的新定时器唤醒, 重新计算
+            }
+            wake_tick_ = 0;  // 处理期间新加的定时器不必唤醒驱动线程
+            lk.unlock();
+            Advance(Clock::now());
+            lk.lock();
+        }
+    }
+
+    TimerWheelOptions options_;
+    Clock::time_point const start_;  // 第 0 个 tick 的时刻
+
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;
+    Node* wheel_[kLevels][kSlots]{};          // 各层槽位的链表头
+    std::uint64_t current_{0};                // 下一个要处理的 tick
+    std::uint64_t wake_tick_{kNever};         // 驱动线程预定醒来的 tick
+    std::size_t pending_{0};                  // 尚未触发的定时器个数
+    Node* free_{nullptr};                     // 对象池空闲链表
+    std::vector<UniquePtr<Node[]>> chunks_;   // 对象池的内存块
+    bool stopping_{false};
+    std::thread driver_;
+};
+
+}  // namespace cutestl
@@ -6,6 +6,8 @@
 #include <memory>    // For std::default_delete
 #include <utility>   // For std::move, std::forward, std::swap
 
+#include "_niche.hpp"
+
 namespace cutestl {
 
 // 前向声明
@@ -250,6 +252,22 @@ bool operator==(const UniquePtr<T, D>& ptr, std::nullptr_t) noexcept {
 
 // 其他比较运算符 (`!=`, `<`, `>`, `<=`, `>=`) 由 <=> 自动推导
 
+// 生态位: 哨兵是持有 _NichePointer 的 UniquePtr, 只对无状态删除器开放 (哨兵不会被析构)
+template <typename T, typename Deleter>
+    requires(std::is_empty_v<Deleter> && std::is_trivially_destructible_v<Deleter> &&
+             std::is_nothrow_default_constructible_v<Deleter>)
+struct NicheTraits<UniquePtr<T, Deleter>> {
+    using Ptr = UniquePtr<T, Deleter>;
+
+    static void SetEmpty(Ptr* storage) noexcept {
+        std::construct_at(storage, _NichePointer<typename Ptr::pointer>());
+    }
+
+    static bool IsEmpty(Ptr const& value) noexcept {
+        return value.get() == _NichePointer<typename Ptr::pointer>();
+    }
+};
+
 //==============================================================================
 // 4. 工厂函数 (Factory Functions)
 //==============================================================================
@@ -284,4 +302,109 @@ template <typename T>
     return UniquePtr<T>(new ElementType[size]);
 }
 
+//==============================================================================
+// 5. 分配器感知 (Allocator-aware)
+//==============================================================================
+
+// 用分配器归还内存的删除器: 先析构对象, 再 Deallocate
+// NOTE: 分配器无状态 (如 cutestl::Allocator) 时删除器是空类型, UniquePtr 仍然只有一个指针大
+template <typename Alloc>
+class AllocatorDelete {
+public:
+    using allocator_type = Alloc;
+    using value_type = typename Alloc::value_type;
+
+    AllocatorDelete()
+        requires std::is_default_constructible_v<Alloc>
+    = default;
+
+    explicit AllocatorDelete(Alloc const& alloc) noexcept : alloc_(alloc) {}
+
+    void operator()(value_type* p) noexcept {
+        std::destroy_at(p);
+        alloc_.Deallocate(p, 1);
+    }
+
+    [[nodiscard]] Alloc const& get_allocator() const noexcept { return alloc_; }
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+};
+
+// 用 alloc (会被 rebind 到 T) 分配并构造 T, 返回的 UniquePtr 析构时把内存还给同一个分配器
+template <typename T, typename Alloc, typename... Args>
+    requires(!std::is_array_v<T>)
+[[nodiscard]] auto AllocateUnique(Alloc const& alloc, Args&&... args) {
+    using TAlloc = typename Alloc::template rebind<T>::other;
+    TAlloc t_alloc{alloc};
+    T* p = t_alloc.Allocate(1);
+    try {
+        std::construct_at(p, std::forward<Args>(args)...);
+    } catch (...) {
+        t_alloc.Deallocate(p, 1);  // 构造函数抛异常时归还内存
+        throw;
+    }
+    return UniquePtr<T, AllocatorDelete<TAlloc>>(p, AllocatorDelete<TAlloc>{t_alloc});
+}
+
+// 数组版本的删除器: 记住元素个数 n, 析构 n 个元素后 Deallocate(p, n)
+template <typename Alloc>
+class AllocatorArrayDelete {
+public:
+    using allocator_type = Alloc;
+    using value_type = typename Alloc::value_type;
+
+    AllocatorArrayDelete() noexcept
+        requires std::is_default_constructible_v<Alloc>
+    = default;
+
+    AllocatorArrayDelete(Alloc const& alloc, size_t n) noexcept : alloc_(alloc), n_(n) {}
+
+    void operator()(value_type* p) noexcept {
+        std::destroy_n(p, n_);
+        alloc_.Deallocate(p, n_);
+    }
+
+    [[nodiscard]] size_t size() const noexcept { return n_; }
+
+    [[nodiscard]] Alloc const& get_allocator() const noexcept { return alloc_; }
+
+private:
+    [[no_unique_address]] Alloc alloc_;
+    size_t n_{0};
+};
+
+template <typename T, typename Alloc, typename Init>
+auto _AllocateUniqueArray(Alloc const& alloc, size_t n, Init init) {
+    using ElementType = std::remove_extent_t<T>;
+    using TAlloc = typename Alloc::template rebind<ElementType>::other;
+    TAlloc t_alloc{alloc};
+    ElementType* p = t_alloc.Allocate(n);
+    try {
+        init(p, n);
+    } catch (...) {
+        t_alloc.Deallocate(p, n);
+        throw;
+    }
+    return UniquePtr<T, AllocatorArrayDelete<TAlloc>>(p, AllocatorArrayDelete<TAlloc>{t_alloc, n});
+}
+
+// 数组版本 (值初始化): AllocateUnique<float[]>(AlignedAllocator<float>{}, n)
+template <typename T, typename Alloc>
+    requires(std::is_unbounded_array_v<T>)
+[[nodiscard]] auto AllocateUnique(Alloc const& alloc, size_t n) {
+    return _AllocateUniqueArray<T>(alloc, n, [](auto* p, size_t count) {
+        std::uninitialized_value_construct_n(p, count);
+    });
+}
+
+// 数组版本 (默认初始化): 平凡类型不清零, 适合马上会被整体写满的大缓冲区
+template <typename T, typename Alloc>
+    requires(std::is_unbounded_array_v<T>)
+[[nodiscard]] auto AllocateUniqueForOverwrite(Alloc const& alloc, size_t n) {
+    return _AllocateUniqueArray<T>(alloc, n, [](auto* p, size_t count) {
+        std::uninitialized_default_construct_n(p, count);
+    });
+}
+
 }  // namespace cutestl
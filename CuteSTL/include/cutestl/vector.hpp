@@ -61,16 +61,15 @@ public:
     ~Vector() noexcept {
         if (start_) {
             std::destroy(start_, finish_);  // 1. 调用每个元素的析构函数
-            Alloc::Deallocate(start_);      // 2. 释放 start_ 指向的内存
+            Alloc::Deallocate(start_, Capacity());  // 2. 释放 start_ 指向的内存
         }
     }
 
 public:
     // NOTE: 使用委托构造简略写法
-    Vector(Vector const& other) : Vector(other.begin(), other.end()) { fmt::println("拷贝构造"); }
+    Vector(Vector const& other) : Vector(other.begin(), other.end()) {}
 
     Vector(Vector&& other) noexcept {
-        fmt::println("移动构造");
         start_ = other.start_;
         finish_ = other.finish_;
         end_of_storage_ = other.end_of_storage_;
@@ -81,7 +80,6 @@ public:
 
 public:
     Vector& operator=(Vector const& other) {
-        fmt::println("拷贝赋值");
         if (this != &other) {
             // 1. 如果 other.size > capacity 则重新分配内存
             if (other.Size() > Capacity()) {
@@ -105,10 +103,9 @@ public:
     }
 
     Vector& operator=(Vector&& other) noexcept {
-        fmt::println("移动赋值");
         if (this != &other) {
             std::destroy(begin(), end());
-            Alloc::Deallocate(start_);
+            Alloc::Deallocate(start_, Capacity());
             start_ = other.start_;
             finish_ = other.finish_;
             end_of_storage_ = other.end_of_storage_;
@@ -158,9 +155,10 @@ public:
             return;
         }
         iterator new_start{Alloc::Allocate(n)};
-        iterator new_finish{std::uninitialized_copy(begin(), end(), new_start)};
+        // NOTE: 与 Insert 扩容一致, 搬移而不是拷贝元素
+        iterator new_finish{std::uninitialized_move(begin(), end(), new_start)};
         std::destroy(start_, finish_);
-        Alloc::Deallocate(start_);
+        Alloc::Deallocate(start_, Capacity());
         start_ = new_start;
         finish_ = new_finish;
         end_of_storage_ = start_ + n;
@@ -189,7 +187,7 @@ public:
             ++new_finish;
             new_finish = std::uninitialized_move(pos, finish_, new_finish);
             std::destroy(start_, finish_);
-            Alloc::Deallocate(start_);
+            Alloc::Deallocate(start_, Capacity());
             start_ = new_start;
             finish_ = new_finish;
             end_of_storage_ = start_ + new_size;
@@ -223,7 +221,7 @@ public:
             ++new_finish;
             new_finish = std::uninitialized_move(pos, finish_, new_finish);
             std::destroy(start_, finish_);
-            Alloc::Deallocate(start_);
+            Alloc::Deallocate(start_, Capacity());
             start_ = new_start;
             finish_ = new_finish;
             end_of_storage_ = start_ + new_size;
@@ -236,7 +234,7 @@ public:
         if (n == 0) {
             return pos;
         }
-        if (end_of_storage_ - finish_ > n) {
+        if (static_cast<size_type>(end_of_storage_ - finish_) >= n) {
             size_type elemts_after = finish_ - pos;  // pos 和 end() 之间的元素个数
             if (elemts_after > n) {                  // 切分原数组
                 std::uninitialized_move(finish_ - n, finish_, finish_);
@@ -261,7 +259,7 @@ public:
             new_finish = std::uninitialized_fill_n(new_finish, n, val);      // 2. 填充中间部分
             new_finish = std::uninitialized_move(pos, finish_, new_finish);  // 3. 移动右边部分
             std::destroy(start_, finish_);
-            Alloc::Deallocate(start_);
+            Alloc::Deallocate(start_, Capacity());
             start_ = new_start;
             finish_ = new_finish;
             end_of_storage_ = start_ + new_size;
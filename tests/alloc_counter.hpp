@@ -0,0 +1,62 @@
+#pragma once
+
+// 测试用: 替换全局 operator new/delete, 统计堆分配与释放次数 (验证某些路径不分配或只分配一次)
+// NOTE: 定义了全局替换函数, 每个测试程序只能有一个源文件包含本头文件
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace cutestl_test {
+
+inline std::atomic<std::size_t> g_allocations{0};
+inline std::atomic<std::size_t> g_deallocations{0};
+
+// 当前已发生的堆分配次数
+inline std::size_t Allocations() noexcept {
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+// 当前已发生的堆释放次数 (不含空指针)
+inline std::size_t Deallocations() noexcept {
+    return g_deallocations.load(std::memory_order_relaxed);
+}
+
+inline void* CountedAllocate(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+inline void CountedDeallocate(void* p) noexcept {
+    if (p != nullptr) {
+        g_deallocations.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::free(p);
+}
+
+}  // namespace cutestl_test
+
+// NOTE: 所有形式的 new/delete 都走 malloc/free, 保证成对;
+// noinline 防止 GCC 把 free 内联到 new 表达式旁边而误报 -Wmismatched-new-delete
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    return cutestl_test::CountedAllocate(size);
+}
+[[gnu::noinline]] void* operator new[](std::size_t size) {
+    return cutestl_test::CountedAllocate(size);
+}
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    cutestl_test::CountedDeallocate(p);
+}
+[[gnu::noinline]] void operator delete[](void* p) noexcept {
+    cutestl_test::CountedDeallocate(p);
+}
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept {
+    cutestl_test::CountedDeallocate(p);
+}
+[[gnu::noinline]] void operator delete[](void* p, std::size_t) noexcept {
+    cutestl_test::CountedDeallocate(p);
+}
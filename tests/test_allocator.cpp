@@ -0,0 +1,59 @@
+#include <cassert>
+#include <cstdint>
+#include <cutestl/allocator.hpp>
+#include <cutestl/unique_ptr.hpp>
+#include <cutestl/vector.hpp>
+#include <iostream>
+#include <string>
+
+using namespace cutestl;
+
+template <typename T>
+bool IsAligned(T const* p, std::size_t align) {
+    return reinterpret_cast<std::uintptr_t>(p) % align == 0;
+}
+
+// 无状态分配器: 数组删除器只多存一个 n
+static_assert(sizeof(decltype(AllocateUnique<float[]>(AlignedAllocator<float>{}, 1))) ==
+              2 * sizeof(void*));
+
+int main() {
+    {
+        auto buf = AllocateUnique<float[]>(AlignedAllocator<float, 64>{}, 100);
+        assert(IsAligned(buf.get(), 64) && buf.get_deleter().size() == 100);
+        for (int i = 0; i < 100; ++i) {
+            assert(buf[i] == 0.0f);  // 值初始化
+        }
+        auto page = AllocateUniqueForOverwrite<char[]>(AlignedAllocator<char, 4096>{}, 10);
+        assert(IsAligned(page.get(), 4096));
+    }
+
+    {
+        Vector<double, AlignedAllocator<double, 64>> v;
+        for (int i = 0; i < 1000; ++i) {
+            v.PushBack(i);
+            assert(IsAligned(&v[0], 64));
+        }
+        assert(v[999] == 999.0);
+    }
+
+    {
+        // 小请求走 operator new, 大请求走 mmap + 2 MiB 对齐
+        constexpr std::size_t kHuge = HugePageAllocator<char>::kHugePageSize;
+        auto small = AllocateUnique<std::string[]>(HugePageAllocator<std::string>{}, 3);
+        small[2] = "tail";
+        assert(small[2] == "tail" && IsAligned(small.get(), 64));
+
+        auto big = AllocateUniqueForOverwrite<std::uint32_t[]>(HugePageAllocator<char>{},
+                                                               kHuge / 2 + 1);
+        assert(IsAligned(big.get(), kHuge));
+        for (std::size_t i = 0; i < kHuge / 2 + 1; i += 1024) {
+            assert(big[i] == 0);  // mmap 的内存已清零
+            big[i] = static_cast<std::uint32_t>(i);
+        }
+        assert(big[1024] == 1024);
+    }
+
+    std::cout << "All Allocator tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <cassert>
+#include <cstdint>
+#include <cutestl/allocator.hpp>
+#include <cutestl/arena.hpp>
+#include <cutestl/optional.hpp>
+#include <cutestl/unique_ptr.hpp>
+#include <iostream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+using namespace cutestl;
+
+static int g_alive = 0;
+
+struct Session {
+    std::string user_;
+    int id_;
+    Session(std::string user, int id) : user_(std::move(user)), id_(id) { ++g_alive; }
+    ~Session() { --g_alive; }
+};
+
+struct Throwing {
+    Throwing() { throw std::runtime_error("ctor"); }
+};
+
+struct alignas(64) CacheLine {
+    char bytes_[64];
+};
+
+// 无状态分配器: 删除器不占空间
+static_assert(sizeof(decltype(AllocateUnique<int>(Allocator<int>{}, 0))) == sizeof(int*));
+static_assert(sizeof(ArenaPtr<Session>) == sizeof(Session*));
+static_assert(sizeof(Optional<ArenaPtr<Session>>) == sizeof(Session*));
+
+int main() {
+    {
+        auto p = AllocateUnique<Session>(Allocator<char>{}, "alice", 1);
+        assert(p->user_ == "alice" && g_alive == 1);
+        p.reset();
+        assert(g_alive == 0);
+    }
+
+    {
+        Arena arena{1024};
+        {
+            ArenaAllocator<Session> alloc{arena};
+            auto s = AllocateUnique<Session>(alloc, "bob", 2);
+            assert(s->id_ == 2 && g_alive == 1);
+            assert(&s.get_deleter().get_allocator().GetArena() == &arena);
+
+            ArenaPtr<Session> t = MakeArenaPtr<Session>(arena, "carol", 3);
+            ArenaPtr<int> n = MakeArenaPtr<int>(arena, 42);
+            assert(*n == 42 && g_alive == 2);
+
+            auto* line = ArenaAllocator<CacheLine>{arena}.Allocate(3);
+            assert(reinterpret_cast<std::uintptr_t>(line) % 64 == 0);
+
+            bool thrown = false;
+            try {
+                (void)AllocateUnique<Throwing>(alloc);
+            } catch (std::runtime_error const&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        assert(g_alive == 0);
+        assert(arena.BytesUsed() > 0);
+
+        // 大块单独分配, 不打断当前块的顺序分配
+        void* small = arena.Allocate(8);
+        void* big = arena.Allocate(4096);
+        void* next = arena.Allocate(8);
+        assert(big && static_cast<char*>(next) == static_cast<char*>(small) + 16);
+
+        std::size_t reserved = arena.BytesReserved();
+        arena.Reset();
+        assert(arena.BytesUsed() == 0 && arena.BytesReserved() < reserved);
+        for (int i = 0; i < 1000; ++i) {
+            ArenaPtr<Session> s = MakeArenaPtr<Session>(arena, "dave", i);
+            assert(s->id_ == i);
+        }
+        assert(g_alive == 0);
+    }
+
+    {
+        // 超大的请求: 快路径的边界检查不能因为加法回绕而放行
+        Arena arena{1024};
+        void* first = arena.Allocate(16);
+        std::size_t used = arena.BytesUsed();
+        for (std::size_t bytes : {std::numeric_limits<std::size_t>::max(),
+                                  std::numeric_limits<std::size_t>::max() - 8}) {
+            bool thrown = false;
+            try {
+                (void)arena.Allocate(bytes);
+            } catch (std::bad_alloc const&) {
+                thrown = true;
+            }
+            assert(thrown && arena.BytesUsed() == used);
+        }
+        void* second = arena.Allocate(16);
+        assert(static_cast<char*>(second) == static_cast<char*>(first) + 16);
+    }
+
+    std::cout << "All Arena tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <bitset>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/bitset.hpp>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace cutestl;
+
+static void TestSelectInWord() {
+    // 与逐位扫描对照
+    std::mt19937_64 rng{1};
+    for (int round = 0; round < 2000; ++round) {
+        std::uint64_t word = rng() & rng();
+        unsigned k = 0;
+        for (unsigned bit = 0; bit < 64; ++bit) {
+            if ((word >> bit) & 1) {
+                assert(_SelectInWord(word, k++) == bit);
+            }
+        }
+    }
+    assert(_SelectInWord(~std::uint64_t{0}, 63) == 63);
+}
+
+static void TestBitsetBasic() {
+    Bitset<130> bits;  // 跨 3 个字, 最后一个字只用 2 位
+    std::bitset<130> expected;
+    assert(bits.None() && bits.FindFirst() == 130);
+
+    for (std::size_t i : {0, 1, 63, 64, 100, 129}) {
+        bits.Set(i);
+        expected.set(i);
+    }
+    assert(bits.Count() == expected.count());
+    for (std::size_t i = 0; i < 130; ++i) {
+        assert(bits[i] == expected[i]);
+    }
+
+    std::vector<std::size_t> found;
+    for (auto i = bits.FindFirst(); i < bits.Size(); i = bits.FindNext(i)) {
+        found.push_back(i);
+    }
+    assert((found == std::vector<std::size_t>{0, 1, 63, 64, 100, 129}));
+    std::vector<std::size_t> visited;
+    bits.ForEachSetBit([&](std::size_t i) { visited.push_back(i); });
+    assert(visited == found);
+
+    // 取反不能把超出 N 的位带进来
+    Bitset<130> flipped = ~bits;
+    assert(flipped.Count() == 130 - 6);
+    assert((flipped | bits).All());
+    assert((flipped & bits).None());
+    assert((flipped ^ bits) == Bitset<130>{}.Set());
+    assert(Bitset<130>{}.Set().Count() == 130);
+
+    Bitset<130> low{0b1011};
+    bits.AndNot(low);
+    assert(!bits[0] && !bits[1] && bits[63]);
+    bits.Reset(63).Flip(64);
+    assert(bits.FindFirst() == 100);
+    bits.Reset();
+    assert(bits.None());
+
+    static_assert(Bitset<64>{~std::uint64_t{0}}.Size() == 64);
+    static_assert(Bitset<3>{0xff} == Bitset<3>{0b111});
+}
+
+static void TestDynamicBitset() {
+    std::mt19937 rng{7};
+    for (std::size_t n : {0, 1, 63, 64, 65, 1000, 4096}) {
+        DynamicBitset a{n};
+        DynamicBitset b{n};
+        std::vector<bool> ea(n);
+        std::vector<bool> eb(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            ea[i] = rng() % 3 == 0;
+            eb[i] = rng() % 2 == 0;
+            a.Set(i, ea[i]);
+            b.Set(i, eb[i]);
+        }
+
+        DynamicBitset both = a & b;
+        DynamicBitset either = a | b;
+        DynamicBitset diff = a ^ b;
+        DynamicBitset only_a = a;
+        only_a.AndNot(b);
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            assert(both[i] == (ea[i] && eb[i]));
+            assert(either[i] == (ea[i] || eb[i]));
+            assert(diff[i] == (ea[i] != eb[i]));
+            assert(only_a[i] == (ea[i] && !eb[i]));
+            count += ea[i];
+        }
+        assert(a.Count() == count);
+        assert((~a).Count() == n - count);
+
+        std::size_t expected = 0;
+        while (expected < n && !ea[expected]) {
+            ++expected;
+        }
+        for (auto i = a.FindFirst(); i < n; i = a.FindNext(i)) {
+            assert(i == expected);
+            do {
+                ++expected;
+            } while (expected < n && !ea[expected]);
+        }
+        assert(expected == n);
+    }
+
+    // Resize: 新增的位取给定值, 缩小后再扩大不会留下旧的 1
+    DynamicBitset bits{70, true};
+    assert(bits.All() && bits.Count() == 70);
+    bits.Resize(10);
+    assert(bits.Count() == 10);
+    bits.Resize(200);
+    assert(bits.Count() == 10 && bits.FindNext(9) == 200);
+    bits.Resize(260, true);
+    assert(bits.Count() == 70 && bits.FindNext(9) == 200);
+    bits.PushBack(false);
+    bits.PushBack(true);
+    assert(bits.Size() == 262 && bits.Count() == 71 && bits[261] && !bits[260]);
+    bits.Flip();
+    assert(bits.Count() == 262 - 71);
+
+    DynamicBitset pushed;
+    for (int i = 0; i < 300; ++i) {
+        pushed.PushBack(i % 5 == 0);
+    }
+    assert(pushed.Count() == 60);
+    DynamicBitset copy{300};
+    for (std::size_t i = 0; i < 300; i += 5) {
+        copy.Set(i);
+    }
+    assert(copy == pushed);
+    pushed.Clear();
+    assert(pushed.Empty() && pushed.FindFirst() == 0);
+}
+
+static void TestRankSelect() {
+    std::mt19937 rng{11};
+    for (std::size_t n : {0, 1, 511, 512, 513, 70'000}) {
+        for (int density : {1, 20, 100}) {
+            DynamicBitset bits{n};
+            std::vector<std::size_t> ones;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (static_cast<int>(rng() % 100) < density) {
+                    bits.Set(i);
+                    ones.push_back(i);
+                }
+            }
+            RankSelect index{bits.Words()};
+            assert(index.Ones() == ones.size());
+            std::size_t rank = 0;
+            for (std::size_t i = 0; i <= n; ++i) {
+                assert(index.Rank(i) == rank);
+                if (i < n && bits[i]) {
+                    ++rank;
+                }
+            }
+            for (std::size_t k = 0; k < ones.size(); ++k) {
+                assert(index.Select(k) == ones[k]);
+                assert(index.Rank(ones[k]) == k);
+            }
+            assert(index.Select(ones.size()) == bits.Words().size() * 64);
+        }
+    }
+
+    Bitset<1000> fixed;
+    fixed.Set(3).Set(700).Set(999);
+    RankSelect index{fixed.Words()};
+    assert(index.Rank(701) == 2 && index.Select(2) == 999);
+}
+
+int main() {
+    TestSelectInWord();
+    TestBitsetBasic();
+    TestDynamicBitset();
+    TestRankSelect();
+    std::cout << "All Bitset tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,193 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/concurrent_hash_map.hpp>
+#include <cutestl/shared_ptr.hpp>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 建议在 ThreadSanitizer 下运行
+
+using namespace cutestl;
+
+static void TestBasic() {
+    ConcurrentHashMap<int, int> map{8};
+    assert(map.ShardCount() == 8);
+    assert(map.Empty());
+
+    assert(map.InsertOrAssign(1, 10));
+    assert(!map.InsertOrAssign(1, 11));
+    assert(map.TryEmplace(2, 20));
+    assert(!map.TryEmplace(2, 21));
+    assert(map.Size() == 2);
+
+    int seen = 0;
+    assert(map.FindAndApply(1, [&](int const& v) { seen = v; }));
+    assert(seen == 11);
+    assert(!map.FindAndApply(3, [&](int const&) { assert(false); }));
+
+    assert(map.FindAndModify(2, [](int& v) { v += 5; }));
+    assert(map.Get(2) == 25);
+    assert(!map.Get(3).HasValue());
+    assert(map.Contains(1) && !map.Contains(3));
+
+    int calls = 0;
+    assert(map.ComputeIfAbsent(3, [&] { return ++calls, 30; }) == 30);
+    assert(map.ComputeIfAbsent(3, [&] { return ++calls, 31; }) == 30);
+    assert(calls == 1);
+
+    assert(!map.EraseIf(3, [](int, int v) { return v != 30; }));
+    assert(map.EraseIf(3, [](int, int v) { return v == 30; }));
+    assert(map.Erase(1) == 1);
+    assert(map.Erase(1) == 0);
+
+    int sum = 0;
+    map.ForEach([&](int key, int value) { sum += key + value; });
+    assert(sum == 2 + 25);
+
+    map.Clear();
+    assert(map.Empty());
+
+    // 分片数向上取 2 的幂, 单分片也可用
+    ConcurrentHashMap<int, int> single{1};
+    ConcurrentHashMap<int, int> odd{5};
+    assert(single.ShardCount() == 1 && odd.ShardCount() == 8);
+    for (int i = 0; i < 1000; ++i) {
+        single.InsertOrAssign(i, i);
+        odd.InsertOrAssign(i, i);
+    }
+    assert(single.Size() == 1000 && odd.Size() == 1000);
+}
+
+static void TestHeterogeneous() {
+    ConcurrentHashMap<std::string, int> map;
+    map.InsertOrAssign(std::string{"alpha"}, 1);
+    assert(map.Contains(std::string_view{"alpha"}));
+    assert(map.Get(std::string_view{"alpha"}) == 1);
+    assert(map.Erase(std::string_view{"alpha"}) == 1);
+}
+
+// 多个写者各写一段键, 读者同时查找; 结束后校验内容
+// 有状态的哈希与比较器: 按 modulus_ 取模后相等的键视为同一个键
+struct ModHash {
+    int modulus_ = 0;
+    std::size_t operator()(int key) const {
+        assert(modulus_ != 0);  // 分片内的表也必须拿到用户传入的实例
+        return static_cast<std::size_t>(key % modulus_);
+    }
+};
+
+struct ModEq {
+    int modulus_ = 0;
+    bool operator()(int a, int b) const {
+        assert(modulus_ != 0);
+        return a % modulus_ == b % modulus_;
+    }
+};
+
+static void TestStatefulHash() {
+    ConcurrentHashMap<int, int, ModHash, ModEq> map{4, ModHash{10}, ModEq{10}};
+    assert(map.InsertOrAssign(3, 30));
+    assert(!map.InsertOrAssign(13, 31));  // 13 与 3 是同一个键
+    assert(map.Get(23) == 31);
+    assert(map.Size() == 1);
+    for (int i = 0; i < 100; ++i) {
+        map.TryEmplace(i, i);
+    }
+    assert(map.Size() == 10);
+    assert(map.Erase(43) == 1 && !map.Contains(3));
+}
+
+static void TestConcurrentReadWrite() {
+    constexpr int kWriters = 4;
+    constexpr int kReaders = 4;
+    constexpr int kPerWriter = 20000;
+
+    ConcurrentHashMap<int, std::int64_t> map;
+    std::atomic<bool> done{false};
+    std::vector<std::thread> threads;
+
+    for (int w = 0; w < kWriters; ++w) {
+        threads.emplace_back([&, w] {
+            for (int i = 0; i < kPerWriter; ++i) {
+                int key = w * kPerWriter + i;
+                map.InsertOrAssign(key, std::int64_t{key} * 2);
+                if (i % 3 == 0) {
+                    map.Erase(key);
+                }
+            }
+        });
+    }
+    for (int r = 0; r < kReaders; ++r) {
+        threads.emplace_back([&, r] {
+            std::uint64_t hits = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                for (int key = r; key < kWriters * kPerWriter; key += 97) {
+                    map.FindAndApply(key, [&](std::int64_t const& v) {
+                        assert(v == std::int64_t{key} * 2);
+                        ++hits;
+                    });
+                }
+            }
+            (void)hits;
+        });
+    }
+    for (int w = 0; w < kWriters; ++w) {
+        threads[w].join();
+    }
+    done.store(true, std::memory_order_release);
+    for (int r = 0; r < kReaders; ++r) {
+        threads[kWriters + r].join();
+    }
+
+    std::size_t expected = 0;
+    for (int key = 0; key < kWriters * kPerWriter; ++key) {
+        bool kept = key % kPerWriter % 3 != 0;
+        expected += kept;
+        assert(map.Contains(key) == kept);
+    }
+    assert(map.Size() == expected);
+}
+
+// 所有线程对同一批键调用 ComputeIfAbsent: 每个键的 factory 只执行一次, 所有线程拿到同一个对象
+static void TestComputeIfAbsentOnce() {
+    constexpr int kThreads = 8;
+    constexpr int kKeys = 500;
+
+    ConcurrentHashMap<int, SharedPtr<int>> map;
+    std::atomic<int> created{0};
+    std::vector<std::vector<int*>> seen(kThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int key = 0; key < kKeys; ++key) {
+                SharedPtr<int> p = map.ComputeIfAbsent(key, [&] {
+                    created.fetch_add(1, std::memory_order_relaxed);
+                    return MakeShared<int>(key);
+                });
+                assert(*p == key);
+                seen[t].push_back(p.Get());
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    assert(created.load() == kKeys);
+    for (int t = 1; t < kThreads; ++t) {
+        assert(seen[t] == seen[0]);
+    }
+}
+
+int main() {
+    TestBasic();
+    TestHeterogeneous();
+    TestStatefulHash();
+    TestConcurrentReadWrite();
+    TestComputeIfAbsentOnce();
+    std::cout << "All ConcurrentHashMap tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <cassert>
+#include <cstdint>
+#include <cutestl/flat_hash_map.hpp>
+#include <cutestl/flat_hash_set.hpp>
+#include <cutestl/string.hpp>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+using namespace cutestl;
+
+static int g_alive = 0;
+
+struct Counted {
+    int value_;
+    explicit Counted(int value) : value_(value) { ++g_alive; }
+    Counted(Counted&& other) noexcept : value_(other.value_) { ++g_alive; }
+    Counted(Counted const&) = delete;
+    ~Counted() { --g_alive; }
+};
+
+// 所有键哈希到同一个值: 全部冲突, 检验探测与墓碑
+struct BadHash {
+    std::size_t operator()(int) const noexcept { return 42; }
+};
+
+int main() {
+    {
+        FlatHashMap<int, int> map;
+        assert(map.Empty() && map.Find(1) == map.end() && map.begin() == map.end());
+        for (int i = 0; i < 1000; ++i) {
+            assert(map.Insert({i, i * i}).second);
+        }
+        assert(map.Size() == 1000 && !map.Insert({7, 0}).second);
+        for (int i = 0; i < 1000; ++i) {
+            assert(map.At(i) == i * i);
+        }
+        assert(map.Erase(7) == 1 && map.Erase(7) == 0 && !map.Contains(7));
+        long sum = 0;
+        for (auto const& [key, value] : map) {
+            sum += key;
+        }
+        assert(sum == 999 * 1000 / 2 - 7);
+        map[7] = 49;
+        assert(map.Count(7) == 1 && map.Size() == 1000);
+
+        FlatHashMap<int, int> copy = map;
+        assert(copy == map);
+        copy.Clear();
+        assert(copy.Empty() && copy.Capacity() > 0 && map.Size() == 1000);
+    }
+
+    {
+        // 随机增删, 与 std::unordered_map 对照
+        std::mt19937 rng{12345};
+        FlatHashMap<std::uint32_t, std::uint32_t> map;
+        std::unordered_map<std::uint32_t, std::uint32_t> ref;
+        for (int step = 0; step < 200000; ++step) {
+            std::uint32_t key = rng() % 5000;
+            switch (rng() % 3) {
+                case 0:
+                    map.InsertOrAssign(key, step);
+                    ref[key] = step;
+                    break;
+                case 1:
+                    assert(map.Erase(key) == ref.erase(key));
+                    break;
+                default: {
+                    auto it = map.Find(key);
+                    auto rit = ref.find(key);
+                    assert((it == map.end()) == (rit == ref.end()));
+                    assert(it == map.end() || it->second == rit->second);
+                }
+            }
+        }
+        assert(map.Size() == ref.size());
+        // 反复增删不会让容量无限增长 (墓碑会被回收)
+        assert(map.Capacity() < 4 * 5000);
+    }
+
+    {
+        FlatHashSet<int, BadHash> set;
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 100; ++i) {
+                assert(set.Insert(i).second);
+            }
+            for (int i = 0; i < 100; i += 2) {
+                assert(set.Erase(i) == 1);
+            }
+            for (int i = 1; i < 100; i += 2) {
+                assert(set.Contains(i));
+                assert(set.Erase(i) == 1);
+            }
+            assert(set.Empty());
+        }
+    }
+
+    {
+        // String 键 + std::string_view 异构查找, 查找不构造临时 String
+        FlatHashMap<String, int> map;
+        map.TryEmplace(String{"alpha"}, 1);
+        map.TryEmplace(String{"beta"}, 2);
+        assert(map.Find(std::string_view{"alpha"})->second == 1);
+        assert(map.Contains("beta") && !map.Contains(std::string_view{"gamma"}));
+        assert(map.Erase(std::string_view{"alpha"}) == 1);
+
+        FlatHashSet<std::string> words{"a", "b", "c"};
+        assert(words.Size() == 3 && words.Contains(std::string_view{"b"}));
+        assert(!words.Emplace("a").second);
+    }
+
+    {
+        // TryEmplace: 键已存在时不移动参数
+        FlatHashMap<std::string, std::unique_ptr<int>> map;
+        auto value = std::make_unique<int>(1);
+        assert(map.TryEmplace("k", std::move(value)).second && !value);
+        auto other = std::make_unique<int>(2);
+        assert(!map.TryEmplace("k", std::move(other)).second && other);
+        assert(*map["k"] == 1);
+
+        FlatHashMap<int, Counted> counted;
+        for (int i = 0; i < 100; ++i) {
+            counted.TryEmplace(i, i);
+        }
+        assert(g_alive == 100);
+        counted.Erase(counted.begin());
+        assert(g_alive == 99);
+    }
+    assert(g_alive == 0);
+
+    std::cout << "All FlatHashMap tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <cassert>
+#include <cutestl/flat_map.hpp>
+#include <cutestl/flat_set.hpp>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace cutestl;
+
+static void TestBranchlessSearch() {
+    // 与 std::lower_bound / upper_bound 对照, 覆盖所有长度与重复键
+    std::less<int> comp;
+    for (int n = 0; n < 40; ++n) {
+        std::vector<int> data;
+        for (int i = 0; i < n; ++i) {
+            data.push_back(i / 2 * 2);
+        }
+        for (int key = -1; key <= n + 1; ++key) {
+            assert(_BranchlessLowerBound(data.data(), data.size(), key, comp) ==
+                   std::lower_bound(data.data(), data.data() + n, key));
+            assert(_BranchlessUpperBound(data.data(), data.size(), key, comp) ==
+                   std::upper_bound(data.data(), data.data() + n, key));
+        }
+    }
+}
+
+static void TestFlatMapBasic() {
+    FlatMap<int, std::string> map{{3, "c"}, {1, "a"}, {2, "b"}, {1, "dup"}};
+    assert(map.Size() == 3);
+    assert(map.At(1) == "a");  // 重复键保留最先出现的
+
+    int expected = 1;
+    for (auto [key, value] : map) {
+        assert(key == expected++);
+        assert(value.size() == 1);
+    }
+
+    auto it = map.Find(2);
+    assert(it != map.end() && it->first == 2 && it->second == "b");
+    it->second = "B";
+    assert(map.At(2) == "B");
+    assert(map.Find(4) == map.end());
+    assert(map.Contains(3) && !map.Contains(0));
+
+    assert(map.TryEmplace(0, 3, 'z').second);
+    assert(map.Keys()[0] == 0 && map.Values()[0] == "zzz");
+    assert(!map.TryEmplace(0, "no").second);
+    assert(!map.InsertOrAssign(0, "y").second);
+    assert(map.At(0) == "y");
+    map[5] = "e";
+    assert(map.Size() == 5 && map.Keys()[4] == 5);
+
+    assert(map.LowerBound(4)->first == 5);
+    assert(map.UpperBound(2)->first == 3);
+
+    assert(map.Erase(2) == 1 && map.Erase(2) == 0);
+    auto next = map.Erase(map.Find(0));
+    assert(next->first == 1);
+    assert(map.Size() == 3);
+
+    bool thrown = false;
+    try {
+        map.At(42);
+    } catch (std::out_of_range const&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    FlatMap<int, std::string> const& cref = map;
+    assert(cref.Find(1)->second == "a");
+    assert((cref.end() - cref.begin()) == 3);
+}
+
+static void TestFlatMapBatchMerge() {
+    FlatMap<int, int> map;
+    std::map<int, int> ref;
+    std::mt19937 rng{7};
+    for (int round = 0; round < 20; ++round) {
+        std::vector<std::pair<int, int>> batch;
+        for (int i = 0; i < 200; ++i) {
+            batch.emplace_back(static_cast<int>(rng() % 3000), round * 1000 + i);
+        }
+        map.Insert(batch.begin(), batch.end());
+        for (auto const& [k, v] : batch) {
+            ref.emplace(k, v);  // 与 std::map::insert 一样, 已存在的键不覆盖
+        }
+        assert(map.Size() == ref.size());
+    }
+    auto it = map.begin();
+    for (auto const& [k, v] : ref) {
+        assert(it->first == k && it->second == v);
+        ++it;
+    }
+    for (int key = -5; key < 3005; ++key) {
+        assert(map.Contains(key) == ref.contains(key));
+    }
+
+    // 已排序的一批, 省掉排序
+    FlatMap<int, int> sorted{sorted_unique, Vector<int>{1, 3, 5}, Vector<int>{10, 30, 50}};
+    std::vector<std::pair<int, int>> more{{2, 20}, {3, 99}, {6, 60}};
+    sorted.Insert(sorted_unique, more.begin(), more.end());
+    assert(sorted.Size() == 5 && sorted.At(3) == 30 && sorted.At(6) == 60);
+}
+
+static void TestFlatMapHeterogeneous() {
+    FlatMap<std::string, int, std::less<>> map{{"beta", 2}, {"alpha", 1}};
+    assert(map.Find(std::string_view{"alpha"})->second == 1);
+    assert(map.Contains("beta"));
+    assert(map.Erase(std::string_view{"beta"}) == 1);
+}
+
+static void TestFlatSet() {
+    std::vector<int> raw{5, 1, 4, 1, 5, 9, 2, 6};
+    FlatSet<int> set{raw.begin(), raw.end()};
+    std::set<int> ref{raw.begin(), raw.end()};
+    assert(set.Size() == ref.size());
+    assert(std::equal(set.begin(), set.end(), ref.begin(), ref.end()));
+
+    assert(set.Insert(3).second && !set.Insert(3).second);
+    assert(set.Contains(3) && !set.Contains(7));
+    assert(*set.LowerBound(7) == 9 && *set.UpperBound(5) == 6);
+    assert(set.Erase(1) == 1 && set.Erase(1) == 0);
+
+    set.Insert({8, 0, 9});
+    FlatSet<int> expected{0, 2, 3, 4, 5, 6, 8, 9};
+    assert(set == expected);
+}
+
+int main() {
+    TestBranchlessSearch();
+    TestFlatMapBasic();
+    TestFlatMapBatchMerge();
+    TestFlatMapHeterogeneous();
+    TestFlatSet();
+    std::cout << "All FlatMap tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include <cassert>
+#include <array>
+#include <cutestl/functional.hpp>
+#include <future>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "alloc_counter.hpp"  // 统计堆分配次数, 验证小对象不分配
+
+using namespace cutestl;
+
+int Add(int a, int b) { return a + b; }
+
+int Sum(int n, FunctionRef<int(int)> f) {
+    int total = 0;
+    for (int i = 1; i <= n; ++i) {
+        total += f(i);
+    }
+    return total;
+}
+
+int main() {
+    std::size_t before = cutestl_test::Allocations();
+
+    // 函数指针与无捕获 lambda 不分配
+    Function<int(int, int)> f1{Add};
+    Function<int(int, int)> f2{[](int a, int b) { return a * b; }};
+    assert(f1(2, 3) == 5);
+    assert(f2(2, 3) == 6);
+
+    // 捕获不超过 3 个指针的 lambda 不分配, 拷贝/移动也不分配
+    int base = 10;
+    long scale = 2;
+    Function<int(int)> f3{[&base, &scale](int x) { return static_cast<int>(base + x * scale); }};
+    Function<int(int)> f4{f3};
+    Function<int(int)> f5{std::move(f4)};
+    assert(f3(1) == 12 && f5(2) == 14);
+    assert(!f4);
+    assert(cutestl_test::Allocations() == before);
+
+    // 大对象在堆上, 行为不变
+    std::string big(100, 'x');
+    std::array<char, 64> pad{};
+    Function<std::size_t()> f6{[big, pad] { return big.size() + pad.size(); }};
+    Function<std::size_t()> f7;
+    f7 = f6;
+    assert(f6() == 164 && f7() == 164);
+
+    // 有状态的仿函数被拷贝后各自独立
+    Function<int()> counter{[n = 0]() mutable { return ++n; }};
+    Function<int()> counter2 = counter;
+    assert(counter() == 1 && counter() == 2 && counter2() == 1);
+
+    // 移动后再赋值、自赋值
+    counter = std::move(counter2);
+    counter = counter;
+    assert(counter() == 2);
+
+    bool thrown = false;
+    try {
+        Function<void()>{}();
+    } catch (std::bad_function_call const&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // MoveOnlyFunction: 保存只能移动的捕获
+    std::packaged_task<int()> task{[] { return 42; }};
+    std::future<int> fut = task.get_future();
+    before = cutestl_test::Allocations();
+    MoveOnlyFunction<void()> job{[task = std::move(task)]() mutable { task(); }};
+    MoveOnlyFunction<void()> job2{std::move(job)};
+    assert(cutestl_test::Allocations() == before && !job && job2);
+    job2();
+    assert(fut.get() == 42);
+    job2 = nullptr;
+    assert(!job2);
+
+    auto owned = std::make_unique<int>(7);
+    MoveOnlyFunction<int(int)> take{[p = std::move(owned)](int x) { return *p + x; }};
+    assert(take(1) == 8);
+
+    // FunctionRef: 两个指针大小, 不分配
+    static_assert(sizeof(FunctionRef<int(int)>) == 2 * sizeof(void*));
+    before = cutestl_test::Allocations();
+    int offset = 1;
+    assert(Sum(3, [&](int x) { return x + offset; }) == 9);
+    assert(Sum(3, +[](int x) { return x * x; }) == 14);
+    assert(Sum(3, f3) == 3 * 10 + 6 * 2);
+    assert(cutestl_test::Allocations() == before);
+
+    // 签名返回 void 时, 有返回值的可调用对象也能包装, 返回值被丢弃
+    int calls = 0;
+    Function<void()> discard{[&calls] { return ++calls; }};
+    MoveOnlyFunction<void()> discard_move{[&calls] { return ++calls; }};
+    FunctionRef<void(int)> discard_ref{+[](int x) { return x; }};
+    auto bump = [&calls](int x) { return calls += x; };
+    FunctionRef<void(int)> discard_obj{bump};
+    discard();
+    discard_move();
+    discard_ref(1);
+    discard_obj(10);
+    assert(calls == 12);
+
+    std::cout << "test_function passed\n";
+}
@@ -0,0 +1,87 @@
+#include <cassert>
+#include <cutestl/intrusive_ptr.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace cutestl;
+
+static int g_alive = 0;
+
+struct Expr : RefCounted<Expr> {
+    Expr() { ++g_alive; }
+    Expr(Expr const& other) : RefCounted(other) { ++g_alive; }
+    virtual ~Expr() { --g_alive; }
+    virtual int Eval() const = 0;
+};
+
+struct Literal : Expr {
+    int value_;
+    explicit Literal(int value) : value_(value) {}
+    int Eval() const override { return value_; }
+};
+
+struct Add : Expr {
+    IntrusivePtr<Expr> lhs_, rhs_;
+    Add(IntrusivePtr<Expr> lhs, IntrusivePtr<Expr> rhs)
+        : lhs_(std::move(lhs)), rhs_(std::move(rhs)) {}
+    int Eval() const override { return lhs_->Eval() + rhs_->Eval(); }
+};
+
+struct Token : RefCounted<Token, false> {
+    int kind_ = 0;
+};
+
+int main() {
+    static_assert(sizeof(IntrusivePtr<Expr>) == sizeof(Expr*));
+
+    {
+        IntrusivePtr<Expr> one = MakeIntrusive<Literal>(1);
+        IntrusivePtr<Expr> sum = MakeIntrusive<Add>(one, MakeIntrusive<Literal>(2));
+        assert(sum->Eval() == 3 && one->UseCount() == 2);
+
+        // 裸指针往返不重复计数
+        Expr* raw = one.Get();
+        IntrusivePtr<Expr> again{raw};
+        assert(raw->UseCount() == 3 && again == one);
+
+        // Detach 与接管
+        Expr* detached = again.Detach();
+        assert(!again && raw->UseCount() == 3);
+        IntrusivePtr<Expr> adopted{detached, false};
+        assert(raw->UseCount() == 3);
+
+        // 拷贝对象不拷贝计数
+        Literal copy = static_cast<Literal const&>(*one);
+        assert(copy.UseCount() == 0 && copy.Eval() == 1);
+    }
+    assert(g_alive == 0);
+
+    // 多线程共享同一个节点
+    {
+        IntrusivePtr<Expr> shared = MakeIntrusive<Literal>(7);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([shared] {
+                for (int i = 0; i < 10000; ++i) {
+                    IntrusivePtr<Expr> copy = shared;
+                    assert(copy->Eval() == 7);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        assert(shared->UseCount() == 1);
+    }
+    assert(g_alive == 0);
+
+    // 非原子计数
+    IntrusivePtr<Token> token = MakeIntrusive<Token>();
+    IntrusivePtr<Token> other = token;
+    assert(token->UseCount() == 2);
+    other.Reset();
+    assert(token->UseCount() == 1);
+
+    std::cout << "test_intrusive_ptr passed\n";
+}
@@ -0,0 +1,151 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/list.hpp>
+#include <cutestl/lru_cache.hpp>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 建议在 ThreadSanitizer / AddressSanitizer 下运行
+
+using namespace cutestl;
+
+static std::atomic<int> g_alive{0};
+
+struct Blob {
+    explicit Blob(int value) : value_(value) { g_alive.fetch_add(1, std::memory_order_relaxed); }
+    ~Blob() { g_alive.fetch_sub(1, std::memory_order_relaxed); }
+
+    int value_;
+};
+
+static void TestListExtensions() {
+    List<std::string> list;
+    auto it = list.Emplace(list.End(), 3, 'a');
+    list.Emplace(list.End(), "b");
+    list.Emplace(it, "c");
+    assert(list.Size() == 3);
+    assert(*list.Begin() == "c");
+    auto next = list.Erase(it);
+    assert(*next == "b" && list.Size() == 2);
+    std::vector<std::string> more{"x", "y"};
+    auto first = list.Insert(list.End(), more.begin(), more.end());
+    assert(*first == "x" && list.Size() == 4);
+    list.Clear();
+    assert(list.Empty() && list.Begin() == list.End());
+}
+
+static void TestBasic() {
+    LruCache<int, Blob> cache{100, 1};
+    assert(cache.ShardCount() == 1);
+    assert(cache.Get(1) == nullptr);
+
+    cache.Put(1, MakeShared<Blob>(10), 40);
+    cache.Put(2, MakeShared<Blob>(20), 40);
+    assert(cache.Get(1)->value_ == 10);
+    assert(cache.Size() == 2 && cache.BytesUsed() == 80);
+
+    // 1 刚被访问过, 超预算时放过 1 淘汰 2
+    cache.Put(3, MakeShared<Blob>(30), 40);
+    assert(cache.Contains(1) && !cache.Contains(2) && cache.Contains(3));
+    assert(cache.BytesUsed() == 80);
+
+    // 覆盖已有的键: 更新 charge, 不计入 inserts
+    cache.Put(3, MakeShared<Blob>(31), 20);
+    assert(cache.Get(3)->value_ == 31 && cache.BytesUsed() == 60);
+
+    // 淘汰不影响已经拿到值的读者
+    SharedPtr<Blob> held = cache.Get(1);
+    assert(cache.Erase(1) && !cache.Erase(1));
+    assert(held->value_ == 10);
+
+    LruCacheStats stats = cache.Stats();
+    assert(stats.hits == 3 && stats.misses == 1);
+    assert(stats.inserts == 3 && stats.evictions == 1);
+    assert(stats.entries == 1 && stats.bytes == 20);
+    assert(stats.HitRate() == 0.75);
+
+    // 比整个预算还大的元素不会被缓存, 也不会把其他元素挤出去
+    cache.Put(4, MakeShared<Blob>(40), 1000);
+    assert(!cache.Contains(4) && cache.Contains(3) && cache.BytesUsed() == 20);
+    assert(cache.Stats().evictions == 2);
+
+    cache.Clear();
+    assert(cache.Size() == 0 && cache.BytesUsed() == 0);
+    held = nullptr;
+    assert(g_alive.load() == 0);
+}
+
+static void TestOversizedPut() {
+    LruCache<int, int> cache{100, 1};
+    cache.Put(1, MakeShared<int>(1), 40);
+    cache.Put(2, MakeShared<int>(2), 40);
+    cache.Put(3, MakeShared<int>(3), 500);
+    assert(cache.Contains(1) && cache.Contains(2) && !cache.Contains(3));
+    assert(cache.BytesUsed() == 80);
+
+    // 覆盖成超大的值: 旧值也被删除, 不会再读到过期的值
+    cache.Put(2, MakeShared<int>(20), 500);
+    assert(cache.Get(2) == nullptr && cache.Get(1) != nullptr && cache.BytesUsed() == 40);
+}
+
+// 热点键反复命中后应当留在缓存里, 只被扫描一次的冷键先被淘汰
+static void TestClockKeepsHotKeys() {
+    LruCache<int, int> cache{64 * sizeof(int), 1};
+    for (int key = 0; key < 8; ++key) {
+        cache.Put(key, MakeShared<int>(key));
+    }
+    for (int cold = 100; cold < 1000; ++cold) {
+        for (int key = 0; key < 8; ++key) {
+            assert(cache.Get(key) != nullptr);
+        }
+        cache.Put(cold, MakeShared<int>(cold));
+    }
+    assert(cache.Size() == 64);
+}
+
+static void TestConcurrent() {
+    constexpr int kThreads = 8;
+    constexpr int kOps = 20000;
+    constexpr int kKeys = 512;
+    {
+        LruCache<int, Blob> cache{256 * sizeof(Blob), 8};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&, t] {
+                std::uint32_t seed = 12345u + static_cast<std::uint32_t>(t);
+                for (int i = 0; i < kOps; ++i) {
+                    seed = seed * 1664525u + 1013904223u;
+                    int key = static_cast<int>((seed >> 8) % kKeys);
+                    if (SharedPtr<Blob> blob = cache.Get(key)) {
+                        assert(blob->value_ == key);
+                    } else if (i % 7 == 0) {
+                        cache.Erase(key);
+                    } else {
+                        cache.Put(key, MakeShared<Blob>(key));
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        LruCacheStats stats = cache.Stats();
+        assert(stats.hits + stats.misses == std::uint64_t{kThreads} * kOps);
+        assert(stats.bytes <= 256 * sizeof(Blob));
+        assert(stats.entries * sizeof(Blob) == stats.bytes);
+    }
+    assert(g_alive.load() == 0);
+}
+
+int main() {
+    TestListExtensions();
+    TestBasic();
+    TestOversizedPut();
+    TestClockKeepsHotKeys();
+    TestConcurrent();
+    std::cout << "All LruCache tests passed!" << std::endl;
+    return 0;
+}
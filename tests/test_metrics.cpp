@@ -0,0 +1,108 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cutestl/queue.hpp>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+using namespace std::chrono_literals;
+using namespace cutestl;
+
+using Snapshot = HistogramSnapshot;
+
+// 每个值都落在上界不小于它、前一个桶上界小于它的桶里, 且桶宽不超过下界的 1/8
+static void TestBucketBoundaries() {
+    for (std::uint64_t v = 0; v < 8; ++v) {
+        assert(Snapshot::BucketIndex(v) == v && Snapshot::BucketUpperBound(v) == v);
+    }
+    auto check = [](std::uint64_t v) {
+        std::size_t index = Snapshot::BucketIndex(v);
+        assert(index < Snapshot::kBucketCount);
+        std::uint64_t upper = Snapshot::BucketUpperBound(index);
+        std::uint64_t lower = Snapshot::BucketUpperBound(index - 1) + 1;
+        assert(lower <= v && v <= upper);
+        assert(upper - lower <= lower / 8);
+    };
+    for (std::uint64_t v = 8; v < 5000; ++v) {
+        check(v);
+    }
+    for (int bit = 13; bit < 64; ++bit) {
+        std::uint64_t p = std::uint64_t{1} << bit;
+        check(p - 1);
+        check(p);
+        check(p + 1);
+        check(p + p / 2);
+    }
+    std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+    assert(Snapshot::BucketIndex(max) == Snapshot::kBucketCount - 1);
+    assert(Snapshot::BucketUpperBound(Snapshot::kBucketCount - 1) == max);
+}
+
+static void TestPercentiles() {
+    LogHistogram histogram;
+    Snapshot empty = histogram.Snapshot();
+    assert(empty.Count() == 0 && empty.Percentile(50) == 0 && empty.Mean() == 0.0);
+
+    for (std::uint64_t v = 1; v <= 1000; ++v) {
+        histogram.Record(v);
+    }
+    Snapshot snapshot = histogram.Snapshot();
+    assert(snapshot.Count() == 1000 && snapshot.Sum() == 500500);
+    assert(snapshot.Mean() == 500.5);
+    assert(snapshot.Percentile(0) == 1);
+    // 分位数返回桶上界: 不小于真实值, 相对误差 <= 12.5%
+    for (double p : {10.0, 50.0, 90.0, 99.0}) {
+        auto exact = static_cast<std::uint64_t>(p * 10) + 1;
+        std::uint64_t got = snapshot.Percentile(p);
+        assert(got >= exact && got <= exact + exact / 8);
+    }
+    assert(snapshot.Percentile(100) >= 1000 && snapshot.Percentile(100) <= 1000 + 1000 / 8);
+
+    // 合并
+    LogHistogram other;
+    other.Record(1'000'000);
+    snapshot += other.Snapshot();
+    assert(snapshot.Count() == 1001 && snapshot.Sum() == 1'500'500);
+    assert(snapshot.Percentile(100) >= 1'000'000);
+    assert(snapshot.BucketCount(Snapshot::BucketIndex(1'000'000)) == 1);
+}
+
+static void TestQueueStats() {
+    MtxQueue<int> queue{2};
+    assert(queue.Push(1) && queue.Push(2));
+    assert(!queue.TryPush(3));  // 已满
+    std::this_thread::sleep_for(2ms);
+    assert(*queue.Pop() == 1);
+    assert(*queue.TryPop() == 2);
+    assert(!queue.TryPopFor(1ms));
+    queue.Close();
+    assert(!queue.Push(4));  // 已关闭
+
+    MtxQueueStats stats = queue.Stats();
+    assert(stats.pushed == 2 && stats.popped == 2 && stats.rejected == 2);
+    assert(stats.depth == 0 && stats.max_depth == 2);
+    assert(stats.wait.Count() == 2);
+    assert(stats.wait.Percentile(0) >= 2'000'000);  // 两个元素都至少排队了 2 ms
+
+    // 关闭统计时不读时钟, 直方图为空
+    MtxQueue<int> quiet{8, false};
+    quiet.Push(1);
+    quiet.Pop();
+    assert(quiet.Stats().popped == 1 && quiet.Stats().wait.Count() == 0);
+
+    // Clear 丢弃的元素不计入等待时间, 之后的元素仍然一一对应
+    MtxQueue<int> cleared;
+    cleared.Push(1);
+    cleared.Clear();
+    cleared.Push(2);
+    assert(*cleared.Pop() == 2 && cleared.Stats().wait.Count() == 1);
+}
+
+int main() {
+    TestBucketBoundaries();
+    TestPercentiles();
+    TestQueueStats();
+    std::cout << "All Metrics tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,209 @@
+#include <cassert>
+#include <cstdint>
+#include <cutestl/optional.hpp>
+#include <cutestl/shared_ptr.hpp>
+#include <cutestl/unique_ptr.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+using namespace cutestl;
+
+static int g_alive = 0;
+
+struct Tracked {
+    int value_;
+    explicit Tracked(int value) : value_(value) { ++g_alive; }
+    Tracked(Tracked const& other) : value_(other.value_) { ++g_alive; }
+    Tracked(Tracked&& other) noexcept : value_(other.value_) { ++g_alive; }
+    Tracked& operator=(Tracked const&) = default;
+    Tracked& operator=(Tracked&&) = default;
+    ~Tracked() { --g_alive; }
+};
+
+// 平凡类型: Optional 也必须平凡, 才能放进寄存器传递
+static_assert(std::is_trivially_copyable_v<Optional<int>>);
+static_assert(std::is_trivially_destructible_v<Optional<double*>>);
+static_assert(!std::is_trivially_copyable_v<Optional<std::string>>);
+static_assert(!std::is_copy_constructible_v<Optional<std::unique_ptr<int>>>);
+static_assert(std::is_nothrow_move_constructible_v<Optional<std::string>>);
+
+// 用户类型的生态位: 下标 UINT32_MAX 永远无效
+struct Handle {
+    std::uint32_t index_;
+};
+
+template <>
+struct cutestl::NicheTraits<Handle> {
+    static void SetEmpty(Handle* storage) noexcept { *storage = Handle{UINT32_MAX}; }
+    static bool IsEmpty(Handle const& value) noexcept { return value.index_ == UINT32_MAX; }
+};
+
+static_assert(sizeof(Optional<int*>) == sizeof(int*));
+static_assert(sizeof(Optional<UniquePtr<int>>) == sizeof(int*));
+static_assert(sizeof(Optional<SharedPtr<int>>) == sizeof(SharedPtr<int>));
+static_assert(sizeof(Optional<Handle>) == sizeof(Handle));
+static_assert(sizeof(Optional<long>) == 2 * sizeof(long));
+static_assert(std::is_trivially_copyable_v<Optional<int*>>);
+
+constexpr int ConstexprSum() {
+    Optional<int> a{20};
+    Optional<int> b = a;
+    b = 22;
+    return *a + b.ValueOr(0);
+}
+static_assert(ConstexprSum() == 42);
+
+Optional<int> ParseDigit(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    return nullopt;
+}
+
+int main() {
+    {
+        Optional<int> empty;
+        assert(!empty && empty == nullopt);
+        assert(empty.ValueOr(7) == 7);
+        bool thrown = false;
+        try {
+            (void)empty.Value();
+        } catch (BadOptionalAccess const&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(ParseDigit('5') == 5);
+        assert(ParseDigit('x') == nullopt);
+    }
+
+    {
+        Optional<std::string> s{std::in_place, 3, 'x'};
+        assert(s.HasValue() && *s == "xxx" && s->size() == 3);
+        Optional<std::string> copy = s;
+        Optional<std::string> moved = std::move(copy);
+        assert(moved == s);
+        s.Emplace("abc");
+        assert(s.Value() == "abc");
+        s = nullopt;
+        assert(!s);
+        s.Swap(moved);
+        assert(*s == "xxx" && !moved);
+    }
+
+    {
+        assert(g_alive == 0);
+        Optional<Tracked> a{Tracked{1}};
+        assert(g_alive == 1);
+        Optional<Tracked> b;
+        b = a;
+        assert(g_alive == 2 && b->value_ == 1);
+        a.Reset();
+        assert(g_alive == 1);
+        a = std::move(b);
+        b = nullopt;
+        assert(g_alive == 1 && a->value_ == 1);
+    }
+    assert(g_alive == 0);
+
+    {
+        Optional<std::unique_ptr<int>> p{std::make_unique<int>(9)};
+        Optional<std::unique_ptr<int>> q = std::move(p);
+        assert(**q == 9);
+        std::unique_ptr<int> out = std::move(q).Value();
+        assert(*out == 9);
+    }
+
+    {
+        Optional<std::string> text{"7"};
+        auto digit = text.AndThen([](std::string const& str) { return ParseDigit(str[0]); });
+        assert(digit == 7);
+        auto doubled = digit.Transform([](int v) { return v * 2.5; });
+        static_assert(std::is_same_v<decltype(doubled), Optional<double>>);
+        assert(doubled == 17.5);
+        Optional<int> none;
+        assert(none.Transform([](int v) { return v + 1; }) == nullopt);
+        assert(none.AndThen(ParseDigit) == nullopt);
+        assert(none.OrElse([] { return Optional<int>{3}; }) == 3);
+        assert(digit.OrElse([] { return Optional<int>{3}; }) == 7);
+    }
+
+    {
+        // 回调按 Optional 的值类别拿到 T&、T const& 或 T&&
+        Optional<int> o{1};
+        assert(o.Transform([](int& x) { return ++x; }) == 2 && o == 2);
+        assert(o.AndThen([](int& x) { return Optional<int>{x *= 10}; }) == 20 && o == 20);
+        Optional<int> const& view = o;
+        assert(view.Transform([](int const& x) { return x + 1; }) == 21);
+        assert(view.AndThen([](int const& x) { return Optional<int>{x}; }) == 20);
+
+        Optional<std::unique_ptr<int>> p{std::make_unique<int>(5)};
+        auto taken =
+            std::move(p).Transform([](std::unique_ptr<int>&& ptr) { return std::move(ptr); });
+        assert(**taken == 5 && p && *p == nullptr);
+        Optional<std::unique_ptr<int>> q{std::make_unique<int>(6)};
+        auto value = std::move(q).AndThen([](std::unique_ptr<int>&& ptr) {
+            std::unique_ptr<int> owned = std::move(ptr);
+            return Optional<int>{*owned};
+        });
+        assert(value == 6 && *q == nullptr);
+    }
+
+    {
+        // 生态位: nullptr 仍是有效值, 与空 Optional 区分开
+        Optional<int*> p;
+        assert(!p);
+        p = nullptr;
+        assert(p && *p == nullptr);
+        int x = 1;
+        p.Emplace(&x);
+        assert(**p == 1);
+        p.Reset();
+        assert(p == nullopt);
+
+        Optional<UniquePtr<int>> u{make_unique<int>(3)};
+        Optional<UniquePtr<int>> v = std::move(u);
+        assert(u && *u == nullptr && **v == 3);
+        v = nullopt;
+        assert(!v);
+
+        SharedPtr<int> shared = MakeShared<int>(4);
+        {
+            Optional<SharedPtr<int>> a{shared};
+            Optional<SharedPtr<int>> b = a;
+            assert(shared.UseCount() == 3);
+            b.Reset();
+            assert(shared.UseCount() == 2 && !b);
+            b.Swap(a);
+            assert(!a && **b == 4);
+        }
+        assert(shared.UseCount() == 1);
+
+        Optional<Handle> h;
+        assert(!h);
+        h = Handle{5};
+        assert(h->index_ == 5);
+
+        // 生态位模式下构造抛出异常: 保持为空, 不会析构半成品
+        WeakPtr<int> expired;
+        {
+            SharedPtr<int> temp = MakeShared<int>(6);
+            expired = temp;
+        }
+        Optional<SharedPtr<int>> o;
+        bool thrown = false;
+        try {
+            o.Emplace(expired);
+        } catch (std::bad_weak_ptr const&) {
+            thrown = true;
+        }
+        assert(thrown && !o);
+        Optional<SharedPtr<int>> from{MakeShared<int>(7)};
+        o = from;  // 之后仍可正常使用
+        assert(**o == 7 && from->UseCount() == 2);
+    }
+
+    std::cout << "All Optional tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/priority_queue.hpp>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace cutestl;
+
+static void TestPriorityQueue() {
+    PriorityQueue<int> pq{3, 1, 4, 1, 5, 9, 2, 6};
+    assert(pq.Size() == 8 && pq.Top() == 9);
+    std::vector<int> out;
+    while (!pq.Empty()) {
+        out.push_back(pq.Take());
+    }
+    assert((out == std::vector<int>{9, 6, 5, 4, 3, 2, 1, 1}));
+
+    // 与 std::priority_queue 对照
+    PriorityQueue<std::string, std::greater<std::string>> mine;
+    std::priority_queue<std::string, std::vector<std::string>, std::greater<std::string>> ref;
+    std::mt19937 rng{1};
+    for (int i = 0; i < 2000; ++i) {
+        if (rng() % 3 != 0 || ref.empty()) {
+            std::string s = std::to_string(rng() % 500);
+            mine.Push(s);
+            ref.push(s);
+        } else {
+            assert(mine.Top() == ref.top());
+            mine.Pop();
+            ref.pop();
+        }
+        assert(mine.Size() == ref.size());
+    }
+}
+
+static void TestIndexedHeapBasic() {
+    IndexedHeap<int> heap;
+    auto h5 = heap.Push(5);
+    auto h3 = heap.Push(3);
+    auto h8 = heap.Push(8);
+    auto h1 = heap.Push(1);
+    assert(heap.Top() == 1 && heap.TopHandle() == h1);
+
+    heap.DecreaseKey(h8, 0);
+    assert(heap.Top() == 0 && heap.TopHandle() == h8);
+    heap.IncreaseKey(h8, 10);
+    assert(heap.Top() == 1);
+    heap.Update(h5, 2);
+    assert(heap.Get(h5) == 2);
+
+    assert(heap.Erase(h3) == 3);
+    assert(!heap.Contains(h3) && heap.Contains(h5));
+    assert(heap.Pop() == 1 && heap.Pop() == 2 && heap.Pop() == 10);
+    assert(heap.Empty());
+
+    // 槽位复用后旧句柄失效
+    auto h = heap.Push(42);
+    assert(heap.Contains(h) && !heap.Contains(h1) && !heap.Contains(h5));
+    heap.Clear();
+    assert(heap.Empty() && !heap.Contains(h));
+}
+
+// 随机操作与有序 multiset 对照, 覆盖 2 叉与 4 叉
+template <std::size_t Arity>
+static void TestIndexedHeapRandom() {
+    IndexedHeap<std::int64_t, std::less<std::int64_t>, Arity> heap;
+    std::vector<std::pair<typename decltype(heap)::Handle, std::int64_t>> live;
+    std::mt19937 rng{Arity};
+    for (int i = 0; i < 20000; ++i) {
+        std::uint32_t op = rng() % 5;
+        if (op <= 1 || live.empty()) {
+            std::int64_t v = rng() % 10000;
+            live.emplace_back(heap.Push(v), v);
+        } else if (op == 2) {
+            std::size_t k = rng() % live.size();
+            std::int64_t v = live[k].second - static_cast<std::int64_t>(rng() % 100);
+            heap.DecreaseKey(live[k].first, v);
+            live[k].second = v;
+        } else if (op == 3) {
+            std::size_t k = rng() % live.size();
+            assert(heap.Erase(live[k].first) == live[k].second);
+            live[k] = live.back();
+            live.pop_back();
+        } else {
+            auto by_value = [](auto const& a, auto const& b) { return a.second < b.second; };
+            auto it = std::min_element(live.begin(), live.end(), by_value);
+            std::int64_t top = heap.Pop();
+            assert(top == it->second);
+            // 值相同的元素可能不止一个, 删掉任意一个值相同的即可
+            auto same = std::find_if(live.begin(), live.end(),
+                                     [&](auto const& e) { return !heap.Contains(e.first); });
+            assert(same != live.end() && same->second == top);
+            *same = live.back();
+            live.pop_back();
+        }
+        assert(heap.Size() == live.size());
+    }
+}
+
+// Dijkstra: 网格图上与不带 DecreaseKey 的 std::priority_queue 实现对照
+static void TestDijkstra() {
+    constexpr int kSide = 40;
+    constexpr int kNodes = kSide * kSide;
+    std::mt19937 rng{7};
+    std::vector<int> weight(kNodes);
+    for (int& w : weight) {
+        w = 1 + static_cast<int>(rng() % 9);
+    }
+    auto neighbors = [&](int u, auto&& fn) {
+        int r = u / kSide;
+        int c = u % kSide;
+        if (r > 0) fn(u - kSide);
+        if (r + 1 < kSide) fn(u + kSide);
+        if (c > 0) fn(u - 1);
+        if (c + 1 < kSide) fn(u + 1);
+    };
+
+    constexpr std::int64_t kInf = std::numeric_limits<std::int64_t>::max();
+    using Item = std::pair<std::int64_t, int>;
+
+    std::vector<std::int64_t> dist(kNodes, kInf);
+    IndexedHeap<Item> open;
+    std::vector<IndexedHeap<Item>::Handle> handle(kNodes);
+    dist[0] = 0;
+    handle[0] = open.Push({0, 0});
+    while (!open.Empty()) {
+        auto [d, u] = open.Pop();
+        neighbors(u, [&](int v) {
+            std::int64_t nd = d + weight[v];
+            if (nd < dist[v]) {
+                if (open.Contains(handle[v])) {
+                    open.DecreaseKey(handle[v], {nd, v});
+                } else {
+                    handle[v] = open.Push({nd, v});
+                }
+                dist[v] = nd;
+            }
+        });
+    }
+
+    std::vector<std::int64_t> ref(kNodes, kInf);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> lazy;
+    ref[0] = 0;
+    lazy.push({0, 0});
+    while (!lazy.empty()) {
+        auto [d, u] = lazy.top();
+        lazy.pop();
+        if (d != ref[u]) {
+            continue;
+        }
+        neighbors(u, [&](int v) {
+            if (d + weight[v] < ref[v]) {
+                ref[v] = d + weight[v];
+                lazy.push({ref[v], v});
+            }
+        });
+    }
+    assert(dist == ref);
+}
+
+int main() {
+    TestPriorityQueue();
+    TestIndexedHeapBasic();
+    TestIndexedHeapRandom<2>();
+    TestIndexedHeapRandom<4>();
+    TestIndexedHeapRandom<8>();
+    TestDijkstra();
+    std::cout << "All PriorityQueue tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,188 @@
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/reclamation.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// 压力测试: 无锁栈 (Treiber stack) 的弹出节点分别用 EBR 与危险指针回收
+// NOTE: 建议在 ThreadSanitizer / AddressSanitizer 下运行, 释放后访问会被直接报告
+// TSan 下回收算法的栅栏换成 seq_cst RMW (见 _SeqCstFence), 编译没有 -Wtsan 警告
+
+using namespace cutestl;
+
+static std::atomic<int> g_alive{0};
+
+struct Node {
+    static constexpr std::uint32_t kMagic = 0xC0FFEE;
+
+    explicit Node(int value) : value_(value) { g_alive.fetch_add(1, std::memory_order_relaxed); }
+    ~Node() {
+        magic_ = 0;
+        g_alive.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    int value_;
+    std::uint32_t magic_{kMagic};
+    Node* next_{nullptr};
+};
+
+class Stack {
+public:
+    void Push(Node* node) {
+        node->next_ = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next_, node, std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    // EBR: 临界区内读取 top->next_ 是安全的
+    bool PopEpoch(EpochDomain& domain, int& out) {
+        EpochGuard guard{domain};
+        Node* top = head_.load(std::memory_order_acquire);
+        while (top) {
+            assert(top->magic_ == Node::kMagic);
+            if (head_.compare_exchange_weak(top, top->next_, std::memory_order_acq_rel,
+                                            std::memory_order_acquire)) {
+                out = top->value_;
+                domain.Retire(top);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 危险指针: 先保护再解引用
+    bool PopHazard(HazardDomain& domain, int& out) {
+        HazardPointer hp{domain};
+        while (Node* top = hp.Protect(head_)) {
+            assert(top->magic_ == Node::kMagic);
+            Node* next = top->next_;
+            if (head_.compare_exchange_strong(top, next, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                out = top->value_;
+                hp.Reset();
+                domain.Retire(top);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Node* Drain() { return head_.exchange(nullptr); }
+
+private:
+    std::atomic<Node*> head_{nullptr};
+};
+
+template <typename PopFn>
+void Stress(PopFn pop) {
+    constexpr int kThreads = 4;
+    constexpr int kOpsPerThread = 20000;
+    Stack stack;
+    std::atomic<long long> popped_sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            long long local = 0;
+            for (int i = 0; i < kOpsPerThread; ++i) {
+                stack.Push(new Node{t * kOpsPerThread + i});
+                int value;
+                if (pop(stack, value)) {
+                    local += value;
+                }
+            }
+            popped_sum.fetch_add(local);
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    // 剩余节点单线程弹出, 核对总和: 每个值恰好被弹出一次
+    long long rest = 0;
+    for (Node* node = stack.Drain(); node;) {
+        rest += node->value_;
+        delete std::exchange(node, node->next_);
+    }
+    long long n = static_cast<long long>(kThreads) * kOpsPerThread;
+    assert(popped_sum + rest == n * (n - 1) / 2);
+}
+
+// 域在仍然存活、用过它的线程之前析构: 该线程之后用新域 (可能分配在同一地址) 以及退出时,
+// 都不能再访问旧域的记录
+template <typename Domain, typename UseFn>
+void DestroyDomainBeforeThread(UseFn use) {
+    auto* domain = new Domain;
+    std::atomic<int> step{0};
+    std::thread worker{[&] {
+        use(*domain);
+        step = 1;
+        while (step != 2) {
+            std::this_thread::yield();
+        }
+        use(*domain);  // 已经是另一个新域
+        step = 3;
+        while (step != 4) {
+            std::this_thread::yield();
+        }
+    }};
+    while (step != 1) {
+        std::this_thread::yield();
+    }
+    delete domain;
+    domain = new Domain;
+    step = 2;
+    while (step != 3) {
+        std::this_thread::yield();
+    }
+    delete domain;  // 线程仍在, 再析构一次
+    step = 4;
+    worker.join();  // 线程退出时不再回调已析构的域
+}
+
+int main() {
+    {
+        EpochDomain domain;
+        Stress([&](Stack& s, int& v) { return s.PopEpoch(domain, v); });
+        // 纪元推进后本线程退休的指针都能被回收
+        for (int i = 0; i < 3; ++i) {
+            domain.Collect();
+        }
+        assert(domain.Pending() == 0);
+    }
+    assert(g_alive == 0);
+
+    {
+        HazardDomain domain;
+        Stress([&](Stack& s, int& v) { return s.PopHazard(domain, v); });
+        domain.Collect();
+        assert(domain.Pending() == 0);
+    }
+    assert(g_alive == 0);
+
+    // 被保护的指针不会被回收
+    {
+        HazardDomain domain;
+        std::atomic<Node*> slot{new Node{1}};
+        HazardPointer hp{domain};
+        Node* node = hp.Protect(slot);
+        slot.store(nullptr);
+        domain.Retire(node);
+        assert(domain.Collect() == 0 && node->magic_ == Node::kMagic);
+        hp.Reset();
+        assert(domain.Collect() == 1);
+    }
+    assert(g_alive == 0);
+
+    DestroyDomainBeforeThread<EpochDomain>([](EpochDomain& domain) {
+        EpochGuard guard{domain};
+        domain.Retire(new Node{2});
+    });
+    DestroyDomainBeforeThread<HazardDomain>([](HazardDomain& domain) {
+        domain.Retire(new Node{3});
+    });
+    assert(g_alive == 0);
+
+    std::cout << "test_reclamation passed\n";
+}
@@ -0,0 +1,201 @@
+#include <atomic>
+#include <cassert>
+#include <cutestl/shared_ptr.hpp>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "alloc_counter.hpp"  // 统计堆分配次数, 验证 MakeShared 只分配一次
+
+using namespace cutestl;
+
+struct Base {
+    virtual ~Base() = default;
+    virtual int Value() const { return 0; }
+};
+
+struct Derived : Base {
+    static inline std::atomic<int> alive = 0;
+    int value_;
+    explicit Derived(int value) : value_(value) { ++alive; }
+    ~Derived() override { --alive; }
+    int Value() const override { return value_; }
+};
+
+// 统计分配/释放次数的 cutestl 风格分配器
+static int g_counted = 0;
+
+template <typename T>
+struct CountingAllocator {
+    using value_type = T;
+    template <typename U>
+    struct rebind {
+        using other = CountingAllocator<U>;
+    };
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(CountingAllocator<U> const&) noexcept {}
+    T* Allocate(std::size_t n) {
+        ++g_counted;
+        return Allocator<T>::Allocate(n);
+    }
+    void Deallocate(T* p, std::size_t n) {
+        --g_counted;
+        Allocator<T>::Deallocate(p, n);
+    }
+};
+
+struct Node : EnableSharedFromThis<Node> {
+    int id_ = 0;
+};
+
+int main() {
+    // MakeShared: 对象与控制块一次分配
+    std::size_t before = cutestl_test::Allocations();
+    {
+        SharedPtr<Derived> p = MakeShared<Derived>(42);
+        assert(cutestl_test::Allocations() == before + 1);
+        assert(p->Value() == 42 && p.UseCount() == 1 && Derived::alive == 1);
+
+        SharedPtr<Base> base = p;  // 派生类到基类
+        assert(base->Value() == 42 && p.UseCount() == 2);
+        p.Reset();
+        assert(Derived::alive == 1 && base.UseCount() == 1);
+    }
+    assert(Derived::alive == 0);
+
+    // 裸指针 + 自定义删除器: 用原始类型删除
+    int deleted = 0;
+    {
+        SharedPtr<Base> p{new Derived{7}, [&deleted](Derived* d) {
+                              ++deleted;
+                              delete d;
+                          }};
+        SharedPtr<Base> q;
+        q = p;
+        assert(q->Value() == 7 && q.UseCount() == 2);
+    }
+    assert(deleted == 1 && Derived::alive == 0);
+
+    // AllocateShared: 通过 rebind 用自定义分配器分配控制块
+    {
+        auto p = AllocateShared<Derived>(CountingAllocator<Derived>{}, 5);
+        assert(g_counted == 1 && p->Value() == 5);
+    }
+    assert(g_counted == 0 && Derived::alive == 0);
+
+    // WeakPtr: 不延长对象寿命, Lock 在对象存活时成功
+    WeakPtr<Base> weak;
+    {
+        auto p = MakeShared<Derived>(3);
+        weak = p;
+        assert(weak.UseCount() == 1 && !weak.Expired());
+        SharedPtr<Base> locked = weak.Lock();
+        assert(locked && locked->Value() == 3 && p.UseCount() == 2);
+    }
+    assert(weak.Expired() && !weak.Lock() && Derived::alive == 0);
+    bool thrown = false;
+    try {
+        SharedPtr<Base> from_weak{weak};
+    } catch (std::bad_weak_ptr const&) {
+        thrown = true;
+    }
+    assert(thrown);
+    weak.Reset();
+
+    // EnableSharedFromThis: 裸指针构造与 MakeShared 都能拿到自己的 SharedPtr
+    {
+        SharedPtr<Node> a{new Node};
+        SharedPtr<Node> b = MakeShared<Node>();
+        assert(a->SharedFromThis().Get() == a.Get());
+        assert(a.UseCount() == 1);
+        assert(b->WeakFromThis().Lock().Get() == b.Get());
+        Node copy = *b;  // 副本不属于任何 SharedPtr
+        thrown = false;
+        try {
+            (void)copy.SharedFromThis();
+        } catch (std::bad_weak_ptr const&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    // 并发: 一边不断 Lock, 一边释放最后一个强引用, 对象只析构一次
+    for (int round = 0; round < 200; ++round) {
+        auto owner = MakeShared<Derived>(round);
+        WeakPtr<Derived> observer{owner};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([observer, round] {
+                for (int i = 0; i < 100; ++i) {
+                    if (SharedPtr<Derived> p = observer.Lock()) {
+                        assert(p->Value() == round);
+                    }
+                }
+            });
+        }
+        owner.Reset();
+        for (auto& t : threads) {
+            t.join();
+        }
+        assert(observer.Expired());
+    }
+    assert(Derived::alive == 0);
+
+    // LocalSharedPtr: 非原子计数, 接口与 SharedPtr 相同
+    {
+        struct Graph : EnableSharedFromThis<Graph, LocalRefCount> {
+            LocalWeakPtr<Graph> parent_;
+        };
+        LocalSharedPtr<Graph> root = MakeLocalShared<Graph>();
+        LocalSharedPtr<Graph> child{new Graph};
+        child->parent_ = root;
+        assert(child->parent_.Lock() == root);
+        assert(root.UseCount() == 1);
+        assert(root->SharedFromThis().Get() == root.Get());
+        int freed = 0;
+        {
+            LocalSharedPtr<Derived> d{new Derived{9}, [&freed](Derived* p) {
+                                          ++freed;
+                                          delete p;
+                                      }};
+            LocalSharedPtr<Base> b = d;
+            assert(b->Value() == 9 && d.UseCount() == 2);
+        }
+        assert(freed == 1);
+        root.Reset();
+        assert(child->parent_.Expired());
+    }
+
+    // AtomicSharedPtr: 读线程无锁读取快照, 写线程不断替换
+    {
+        AtomicSharedPtr<Derived> config{MakeShared<Derived>(0)};
+        std::atomic<bool> done{false};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&] {
+                int last = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    SharedPtr<Derived> snapshot = config.Load();
+                    assert(snapshot && snapshot->Value() >= last);  // 版本单调递增
+                    last = snapshot->Value();
+                }
+            });
+        }
+        for (int version = 1; version <= 2000; ++version) {
+            config.Store(MakeShared<Derived>(version));
+        }
+        SharedPtr<Derived> expected = config.Load();
+        assert(config.CompareExchange(expected, MakeShared<Derived>(3000)));
+        assert(!config.CompareExchange(expected, MakeShared<Derived>(4000)));
+        assert(expected->Value() == 3000);
+        done = true;
+        for (auto& t : readers) {
+            t.join();
+        }
+        assert(config.Exchange(nullptr)->Value() == 3000 && !config.Load());
+    }
+    assert(Derived::alive == 0);
+
+    std::cout << "test_shared_ptr passed\n";
+}
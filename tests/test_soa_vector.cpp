@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cutestl/soa_vector.hpp>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <utility>
+
+using namespace cutestl;
+
+static_assert(std::random_access_iterator<SoaVector<int, double>::iterator>);
+
+// 统计存活对象数, 检查没有泄漏或重复析构
+struct Counted {
+    static inline int alive = 0;
+
+    explicit Counted(int value = 0) : value_(value) { ++alive; }
+    Counted(Counted const& other) : value_(other.value_) { ++alive; }
+    Counted(Counted&& other) noexcept : value_(other.value_) { ++alive; }
+    Counted& operator=(Counted const&) = default;
+    Counted& operator=(Counted&&) noexcept = default;
+    ~Counted() { --alive; }
+
+    int value_;
+};
+
+static void TestBasic() {
+    SoaVector<std::uint64_t, double, std::string> orders;
+    assert(orders.Empty() && orders.Column<1>().empty());
+    for (int i = 0; i < 100; ++i) {
+        orders.EmplaceBack(i, i * 0.5, std::to_string(i));
+    }
+    assert(orders.Size() == 100 && orders.Capacity() >= 100);
+
+    // 列视图连续且按缓存行对齐
+    auto prices = orders.Column<1>();
+    assert(prices.size() == 100);
+    assert(reinterpret_cast<std::uintptr_t>(prices.data()) % kCacheLineSize == 0);
+    assert(std::accumulate(prices.begin(), prices.end(), 0.0) == 0.5 * 99 * 100 / 2);
+
+    // 行代理: 结构化绑定得到引用, 写回原列
+    auto [id, price, name] = orders[7];
+    assert(id == 7 && price == 3.5 && name == "7");
+    price = 100.0;
+    name += "!";
+    assert(orders.Column<1>()[7] == 100.0 && orders.Column<2>()[7] == "7!");
+
+    // 整体赋值
+    orders[8] = std::make_tuple(std::uint64_t{80}, 8.0, std::string{"eighty"});
+    assert(std::get<0>(orders[8]) == 80 && std::get<2>(orders.Back()) == "99");
+
+    std::uint64_t sum = 0;
+    for (auto [order_id, order_price, order_name] : orders) {
+        sum += order_id;
+    }
+    assert(sum == 99 * 100 / 2 - 8 + 80);
+
+    SoaVector<std::uint64_t, double, std::string> const& view = orders;
+    assert(std::get<2>(view.At(0)) == "0");
+    bool thrown = false;
+    try {
+        view.At(100);
+    } catch (std::out_of_range const&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+static void TestIterator() {
+    SoaVector<int, char> rows{{3, 'c'}, {1, 'a'}, {2, 'b'}};
+    auto it = std::find_if(rows.cbegin(), rows.cend(), [](auto row) {
+        return std::get<1>(row) == 'a';
+    });
+    assert(it - rows.cbegin() == 1 && std::get<0>(*it) == 1);
+    SoaVector<int, char>::const_iterator first = rows.begin();
+    assert(first + 3 == rows.cend() && first[2] == std::make_tuple(2, 'b'));
+    assert(std::distance(rows.begin(), rows.end()) == 3);
+}
+
+static void TestModify() {
+    {
+        SoaVector<Counted, std::string> rows{4};
+        assert(rows.Size() == 4 && Counted::alive == 4);
+        for (int i = 0; i < 4; ++i) {
+            std::get<0>(rows[i]).value_ = i;
+            std::get<1>(rows[i]) = std::string(20, static_cast<char>('a' + i));
+        }
+
+        // 实参引用自身元素时扩容也安全
+        assert(rows.Capacity() == rows.Size());
+        rows.EmplaceBack(std::get<0>(rows[0]), std::get<1>(rows[0]));
+        assert(std::get<1>(rows.Back()) == std::string(20, 'a'));
+
+        auto next = rows.Erase(rows.begin() + 1);
+        assert(next - rows.begin() == 1 && std::get<0>(*next).value_ == 2);
+        rows.SwapErase(0);  // 最后一行 (a) 填到第 0 行
+        assert(rows.Size() == 3);
+        assert(std::get<1>(rows[0]) == std::string(20, 'a') && std::get<0>(rows[1]).value_ == 2);
+        rows.PopBack();
+        assert(rows.Size() == 2 && Counted::alive == 2);
+
+        SoaVector<Counted, std::string> copy = rows;
+        assert(Counted::alive == 4 && std::get<1>(copy[1]) == std::get<1>(rows[1]));
+        SoaVector<Counted, std::string> moved = std::move(copy);
+        assert(copy.Empty() && moved.Size() == 2 && Counted::alive == 4);
+        copy = moved;
+        moved = std::move(rows);
+        assert(Counted::alive == 4);
+
+        copy.Resize(10);
+        assert(copy.Size() == 10 && std::get<1>(copy[9]).empty() && Counted::alive == 12);
+        copy.Resize(1);
+        assert(Counted::alive == 3);
+        copy.PushBack(std::make_tuple(Counted{5}, std::string{"x"}));
+        assert(std::get<0>(copy.Back()).value_ == 5);
+        copy.Clear();
+        assert(copy.Empty() && Counted::alive == 2);
+    }
+    assert(Counted::alive == 0);
+}
+
+int main() {
+    TestBasic();
+    TestIterator();
+    TestModify();
+    std::cout << "All SoaVector tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,134 @@
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cutestl/coroutine.hpp>
+#include <cutestl/queue.hpp>
+#include <cutestl/thread_pool.hpp>
+#include <iostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "alloc_counter.hpp"  // 统计堆分配次数, 验证协程帧被复用
+
+using namespace std::chrono_literals;
+using namespace cutestl;
+
+Task<int> Square(ThreadPool& pool, int x) {
+    co_await pool.Schedule();  // 切换到工作线程
+    co_return x * x;
+}
+
+Task<int> SumOfSquares(ThreadPool& pool, int n) {
+    int sum = 0;
+    for (int i = 1; i <= n; ++i) {
+        sum += co_await Square(pool, i);
+    }
+    co_return sum;
+}
+
+Task<std::chrono::milliseconds> Sleep(ThreadPool& pool) {
+    auto start = std::chrono::steady_clock::now();
+    co_await pool.ScheduleAfter(20ms);
+    co_return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+}
+
+Task<int> Consume(MtxQueue<int>& queue) {
+    int total = 0;
+    while (auto value = co_await queue.PopAsync()) {
+        total += *value;
+    }
+    co_return total;
+}
+
+Task<void> Throw(ThreadPool& pool) {
+    co_await pool.Schedule();
+    throw std::runtime_error("boom");
+}
+
+Task<int> Identity(int x) { co_return x; }
+
+// 帧更大, 落在另一个尺寸档
+Task<int> Large(int x) {
+    std::array<int, 100> values{};
+    values[static_cast<std::size_t>(x) % values.size()] = x;
+    co_await std::suspend_never{};
+    co_return values[static_cast<std::size_t>(x) % values.size()];
+}
+
+// FramePool: 同一线程上反复创建/销毁协程, 帧从线程局部缓存复用, 不再分配
+static void TestFrameReuse() {
+    {  // 第一次分配, 销毁后进入本线程的缓存
+        Task<int> small = Identity(0);
+        Task<int> large = Large(0);
+    }
+    std::size_t before = cutestl_test::Allocations();
+    for (int i = 0; i < 1000; ++i) {
+        Task<int> small = Identity(i);
+        Task<int> large = Large(i);  // 两个尺寸档同时在用, 各自复用
+        if (i % 100 == 0) {
+            assert(SyncWait(std::move(small)) == i);  // 执行完的帧同样回收
+            assert(SyncWait(std::move(large)) == i);
+        }
+    }
+    // SyncWait 自己的包装协程不走 FramePool, 每次一次分配
+    assert(cutestl_test::Allocations() - before <= 20);
+}
+
+// 在一个线程创建、在另一个线程销毁的帧进入销毁方线程的缓存; 线程退出时缓存全部释放
+static void TestFrameCrossThread() {
+    constexpr int kTasks = 100;
+    std::vector<Task<int>> tasks;
+    tasks.reserve(kTasks);
+    for (int i = 0; i < kTasks; ++i) {
+        tasks.push_back(Identity(i));
+    }
+    constexpr std::size_t kCached = 64;  // 每档最多缓存 64 个帧, 其余直接释放
+    std::size_t freed_before_exit = 0;
+    std::thread other{[&] {
+        tasks.clear();  // 帧归还到本线程的缓存
+        std::size_t before = cutestl_test::Allocations();
+        std::vector<Task<int>> reused;
+        reused.reserve(kCached);  // 这一次分配属于 vector
+        for (std::size_t i = 0; i < kCached; ++i) {
+            reused.push_back(Identity(static_cast<int>(i)));
+        }
+        assert(cutestl_test::Allocations() - before == 1);
+        reused.clear();
+        freed_before_exit = cutestl_test::Deallocations();
+    }};
+    other.join();
+    // Reaper 在线程退出时释放缓存的帧
+    assert(cutestl_test::Deallocations() - freed_before_exit >= kCached);
+}
+
+int main() {
+    TestFrameReuse();
+    TestFrameCrossThread();
+
+    ThreadPool pool{4};
+
+    assert(SyncWait(SumOfSquares(pool, 10)) == 385);
+    assert(SyncWait(Sleep(pool)) >= 20ms);
+
+    MtxQueue<int> queue;
+    std::jthread producer{[&queue] {
+        std::this_thread::sleep_for(10ms);
+        for (int i = 1; i <= 100; ++i) {
+            queue.Push(i);
+        }
+        queue.Close();
+    }};
+    assert(SyncWait(Consume(queue)) == 5050);
+
+    bool caught = false;
+    try {
+        SyncWait(Throw(pool));
+    } catch (std::runtime_error const&) {
+        caught = true;
+    }
+    assert(caught);
+
+    std::cout << "test_task passed\n";
+}
@@ -0,0 +1,286 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cutestl/thread_pool.hpp>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace cutestl;
+
+static TaskOptions WithPriority(TaskPriority priority) {
+    TaskOptions options;
+    options.priority = priority;
+    return options;
+}
+
+// 让唯一的工作线程卡在一个任务里, 期间提交的任务全部排队, 出队顺序因此是确定的
+class Gate {
+public:
+    explicit Gate(ThreadPool& pool) {
+        std::shared_future<void> released = release_.get_future().share();
+        done_ = pool.Submit(WithPriority(TaskPriority::kCritical), [this, released] {
+            started_ = true;
+            released.wait();
+        });
+        while (!started_) {
+            std::this_thread::yield();
+        }
+    }
+
+    void Release() {
+        release_.set_value();
+        done_.get();
+    }
+
+private:
+    std::promise<void> release_;
+    std::future<void> done_;
+    std::atomic<bool> started_{false};
+};
+
+static ThreadPoolOptions SingleWorker(std::chrono::steady_clock::duration aging) {
+    ThreadPoolOptions options;
+    options.thread_count = 1;
+    options.aging = aging;
+    options.aging_interval = 4;
+    return options;
+}
+
+// 低优先级任务等待过久后, 在持续的高优先级负载下也能很快执行
+static void TestAgingPreventsBackgroundStarvation() {
+    ThreadPool pool{SingleWorker(1ms)};
+    Gate gate{pool};
+    std::vector<int> order;  // 只有唯一的工作线程写入
+    std::vector<std::future<void>> futures;
+    futures.push_back(
+        pool.Submit(WithPriority(TaskPriority::kBackground), [&order] { order.push_back(-1); }));
+    for (int i = 0; i < 200; ++i) {
+        futures.push_back(pool.Submit(WithPriority(TaskPriority::kCritical),
+                                      [&order, i] { order.push_back(i); }));
+    }
+    std::this_thread::sleep_for(5ms);  // 后台任务已老化
+    gate.Release();
+    for (auto& future : futures) {
+        future.get();
+    }
+    auto position = std::find(order.begin(), order.end(), -1) - order.begin();
+    assert(position < 4);
+}
+
+// 后台任务持续积压 (队头总是已老化) 时, 高优先级任务仍然优先, 最多被插队 aging_interval 次
+static void TestAgedBacklogDoesNotStarveCritical() {
+    ThreadPool pool{SingleWorker(0ns)};  // 所有任务入队即老化
+    Gate gate{pool};
+    std::vector<int> order;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit(WithPriority(TaskPriority::kBackground),
+                                      [&order, i] { order.push_back(i); }));
+    }
+    futures.push_back(
+        pool.Submit(WithPriority(TaskPriority::kCritical), [&order] { order.push_back(-1); }));
+    gate.Release();
+    for (auto& future : futures) {
+        future.get();
+    }
+    auto position = std::find(order.begin(), order.end(), -1) - order.begin();
+    assert(position <= 4);
+}
+
+// 有线程在自旋时提交的一批任务不能只由自旋线程串行执行: 取到任务的自旋线程要接力唤醒休眠线程
+static void TestBurstRunsInParallel() {
+    constexpr int kWorkers = 8;
+    ThreadPool pool{kWorkers};
+    for (int round = 0; round < 3; ++round) {
+        // 预热: 其余线程已休眠, 刚执行完任务的线程正在自旋
+        std::this_thread::sleep_for(5ms);
+        pool.Submit([] {}).get();
+
+        std::mutex mtx;
+        std::set<std::thread::id> threads;
+        std::vector<std::future<void>> futures;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kWorkers; ++i) {
+            futures.push_back(pool.Submit([&] {
+                std::this_thread::sleep_for(50ms);
+                std::lock_guard lk{mtx};
+                threads.insert(std::this_thread::get_id());
+            }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        assert(elapsed < 150ms);  // 串行执行需要 400 ms
+        assert(threads.size() >= kWorkers / 2);
+    }
+}
+
+// 计数器与直方图: completed 在任务返回之后才递增, 所以轮询等待
+static void TestStats() {
+    constexpr int kTasks = 100;
+    for (bool collect : {true, false}) {
+        ThreadPoolOptions options;
+        options.thread_count = 2;
+        options.collect_latency = collect;
+        ThreadPool pool{options};
+        std::vector<std::future<void>> futures;
+        for (int i = 0; i < kTasks; ++i) {
+            futures.push_back(pool.Submit([] { std::this_thread::sleep_for(100us); }));
+        }
+        for (auto& future : futures) {
+            future.get();
+        }
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (pool.Stats().completed < kTasks && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+
+        ThreadPoolStats stats = pool.Stats();
+        assert(stats.submitted == kTasks && stats.completed == kTasks);
+        assert(stats.queue_depth == 0 && stats.live_workers == 2);
+        std::uint64_t per_worker = 0;
+        for (std::uint64_t completed : stats.completed_per_worker) {
+            per_worker += completed;
+        }
+        assert(per_worker == kTasks);
+        std::uint64_t samples = collect ? kTasks : 0;
+        assert(stats.queue_wait.Count() == samples && stats.run_time.Count() == samples);
+        if (collect) {
+            assert(stats.run_time.Percentile(0) >= 100'000);  // 每个任务至少执行 100 us
+        }
+    }
+}
+
+// Shutdown 先执行完所有排队任务: 析构 jthread 时的 request_stop 不能让排队任务被当作已取消
+static void TestShutdownDrainsQueue() {
+    constexpr int kTasks = 100;
+    ThreadPool pool{2};
+    std::atomic<int> ran{0};
+    std::atomic<bool> stop_seen{false};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < kTasks; ++i) {
+        futures.push_back(pool.Submit([&](std::stop_token st) {
+            std::this_thread::sleep_for(1ms);
+            stop_seen = stop_seen || st.stop_requested();
+            ++ran;
+        }));
+    }
+    pool.Shutdown();
+    assert(ran == kTasks && !stop_seen);
+    for (auto& future : futures) {
+        future.get();  // 不抛出 TaskCancelled
+    }
+    assert(pool.Stats().completed == kTasks);
+}
+
+// ShutdownNow 丢弃排队任务, 并经 stop_token 通知正在运行的任务
+static void TestShutdownNowStopsRunning() {
+    ThreadPool pool{SingleWorker(200ms)};
+    std::atomic<bool> started{false};
+    std::future<bool> running = pool.Submit([&](std::stop_token st) {
+        started = true;
+        while (!st.stop_requested()) {
+            std::this_thread::yield();
+        }
+        return true;
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::future<void> queued = pool.Submit([] {});
+    assert(pool.ShutdownNow() == 1);
+    assert(running.get());
+    bool broken = false;
+    try {
+        queued.get();
+    } catch (std::future_error const& e) {
+        broken = e.code() == std::future_errc::broken_promise;
+    }
+    assert(broken);
+}
+
+// Post: 同优先级按提交顺序执行, 不同优先级按优先级执行
+static void TestPostOrder() {
+    ThreadPool pool{SingleWorker(1h)};
+    std::vector<int> order;
+    Gate gate{pool};
+    for (int i = 0; i < 10; ++i) {
+        pool.Post([&order, i] { order.push_back(i); });
+    }
+    pool.Post([&order] { order.push_back(-3); }, TaskPriority::kBackground);
+    pool.Post([&order] { order.push_back(-1); }, TaskPriority::kCritical);
+    gate.Release();
+    pool.Shutdown();  // 等待所有 Post 的任务执行完
+    std::vector<int> expected{-1, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, -3};
+    assert(order == expected);
+}
+
+// Post 的任务在 ShutdownNow 时与 Submit 的任务一样被丢弃, 不会执行
+static void TestPostDroppedOnShutdownNow() {
+    ThreadPool pool{SingleWorker(1h)};
+    std::atomic<bool> started{false};
+    std::future<void> running = pool.Submit([&](std::stop_token st) {
+        started = true;
+        while (!st.stop_requested()) {
+            std::this_thread::yield();
+        }
+    });
+    while (!started) {
+        std::this_thread::yield();
+    }
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 5; ++i) {
+        pool.Post([&ran] { ++ran; }, TaskPriority::kCritical);
+    }
+    assert(pool.ShutdownNow() == 5);
+    running.get();
+    assert(ran == 0);
+    bool rejected = false;  // 关停后不能再提交
+    try {
+        pool.Post([&ran] { ++ran; });
+    } catch (std::runtime_error const&) {
+        rejected = true;
+    }
+    assert(rejected && ran == 0);
+}
+
+// SetWorkerAffinity 可以与 Shutdown 并发; 关停后返回 false
+static void TestAffinityDuringShutdown() {
+    ThreadPool pool{2};
+    std::atomic<bool> running{true};
+    std::thread pinner{[&] {
+        while (running) {
+            pool.SetWorkerAffinity(0, CpuSet{0});
+        }
+    }};
+    std::this_thread::sleep_for(1ms);
+    pool.Shutdown();
+    assert(!pool.SetWorkerAffinity(0, CpuSet{0}));
+    running = false;
+    pinner.join();
+}
+
+int main() {
+    TestAgingPreventsBackgroundStarvation();
+    TestAgedBacklogDoesNotStarveCritical();
+    TestBurstRunsInParallel();
+    TestStats();
+    TestShutdownDrainsQueue();
+    TestShutdownNowStopsRunning();
+    TestPostOrder();
+    TestPostDroppedOnShutdownNow();
+    TestAffinityDuringShutdown();
+    std::cout << "All ThreadPool tests passed!" << std::endl;
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cutestl/thread_pool.hpp>
+#include <cutestl/timer_wheel.hpp>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using namespace cutestl;
+
+using Clock = TimerWheel::Clock;
+
+// 手动推进: 每个定时器都在 [deadline, deadline + tick) 之后的第一次 Advance 里触发
+void TestManualAdvance() {
+    TimerWheel wheel{{.tick = 1ms, .start_thread = false}};
+    Clock::time_point base = Clock::now();
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> delay_ms{0, 200'000};  // 覆盖第 0 ~ 2 层
+
+    constexpr int kTimers = 5000;
+    std::vector<Clock::time_point> deadlines(kTimers);
+    std::vector<Clock::time_point> fired_at(kTimers);
+    std::vector<TimerWheel::Handle> handles(kTimers);
+    Clock::time_point now = base;
+    for (int i = 0; i < kTimers; ++i) {
+        deadlines[i] = base + std::chrono::milliseconds{delay_ms(rng)};
+        handles[i] = wheel.ScheduleAt(deadlines[i], [&, i] { fired_at[i] = now; });
+    }
+    assert(wheel.Pending() == kTimers);
+
+    // 取消一半, 重复取消返回 false
+    for (int i = 0; i < kTimers; i += 2) {
+        assert(wheel.Cancel(handles[i]));
+        assert(!wheel.Cancel(handles[i]));
+    }
+    assert(wheel.Pending() == kTimers / 2);
+
+    std::uniform_int_distribution<int> step_ms{1, 3000};
+    Clock::time_point end = base + 201s;
+    std::size_t fired = 0;
+    while (now < end) {
+        Clock::time_point prev = now;
+        now += std::chrono::milliseconds{step_ms(rng)};
+        fired += wheel.Advance(now);
+        for (int i = 1; i < kTimers; i += 2) {
+            if (fired_at[i] == now) {
+                assert(deadlines[i] <= now);       // 不会提前
+                assert(prev < deadlines[i] + 1ms);  // 不会晚于必要的那次推进
+            }
+        }
+    }
+    assert(fired == kTimers / 2);
+    assert(wheel.Pending() == 0);
+    for (int i = 0; i < kTimers; ++i) {
+        assert((fired_at[i] != Clock::time_point{}) == (i % 2 == 1));
+    }
+
+    // 已触发的定时器: 取消返回 false; 节点复用后旧句柄仍然无效
+    assert(!wheel.Cancel(handles[1]));
+    auto handle = wheel.ScheduleAt(now + 5ms, [] {});
+    assert(!wheel.Cancel(handles[1]));
+    assert(!wheel.Cancel(TimerWheel::Handle{}));
+    assert(wheel.Cancel(handle));
+}
+
+// 超出 2^32 个 tick 的定时器先被截断到最高层, 降级时按真实到期时间放置;
+// 空 tick 整段跳过, 所以一次推进很长的时间也很快
+void TestFarTimer() {
+    TimerWheel wheel{{.tick = 1us, .start_thread = false}};
+    Clock::time_point base = Clock::now();
+    int fired = 0;
+    wheel.ScheduleAt(base + 5000s, [&] { ++fired; });  // 5e9 个 tick
+    wheel.ScheduleAt(base + 10ms, [&] { ++fired; });
+
+    assert(wheel.Advance(base + 9ms) == 0);
+    assert(wheel.Advance(base + 11ms) == 1);
+    assert(wheel.Advance(base + 4999s) == 0);
+    assert(fired == 1 && wheel.Pending() == 1);
+    assert(wheel.Advance(base + 5000s + 1ms) == 1);
+    assert(fired == 2 && wheel.Pending() == 0);
+}
+
+// time_point::max() / duration::max() 表示 "永不": 不溢出, 不触发, 可以取消
+void TestNeverDeadline() {
+    TimerWheel wheel{{.start_thread = false}};
+    Clock::time_point base = Clock::now();
+    bool fired = false;
+    auto never = wheel.ScheduleAt(Clock::time_point::max(), [&] { fired = true; });
+    auto later = wheel.ScheduleAfter(Clock::duration::max(), [&] { fired = true; });
+    assert(wheel.Advance(base + 24h) == 0 && !fired);
+    assert(wheel.Pending() == 2);
+    assert(wheel.Cancel(never) && wheel.Cancel(later));
+}
+
+// 已经过期的定时器在下一次推进时触发
+void TestPastDeadline() {
+    TimerWheel wheel{{.start_thread = false}};
+    bool fired = false;
+    wheel.ScheduleAt(Clock::now() - 1s, [&] { fired = true; });
+    wheel.Advance(Clock::now());
+    assert(fired);
+}
+
+// 驱动线程 + 线程池
+void TestDriverWithPool() {
+    ThreadPool pool{4};
+    TimerWheel wheel{{.pool = &pool, .batch_size = 16}};
+    std::atomic<int> fired{0};
+    constexpr int kTimers = 10'000;
+    std::vector<TimerWheel::Handle> handles;
+    handles.reserve(kTimers);
+    std::mt19937 rng{7};
+    std::uniform_int_distribution<int> delay_us{0, 50'000};
+    Clock::time_point start = Clock::now();
+    std::atomic<bool> early{false};
+    for (int i = 0; i < kTimers; ++i) {
+        Clock::time_point deadline = start + std::chrono::microseconds{delay_us(rng)};
+        handles.push_back(wheel.ScheduleAt(deadline, [&, deadline] {
+            if (Clock::now() < deadline) {
+                early = true;
+            }
+            fired.fetch_add(1, std::memory_order_relaxed);
+        }));
+    }
+    // 远的定时器: 在触发之前取消
+    int cancelled = 0;
+    for (int i = 0; i < 100; ++i) {
+        auto handle = wheel.ScheduleAfter(1h, [&] { fired.fetch_add(1000); });
+        cancelled += wheel.Cancel(handle);
+    }
+    assert(cancelled == 100);
+
+    // 空闲一段时间后新加的近定时器要能唤醒驱动线程
+    std::atomic<bool> late{false};
+    Clock::time_point deadline = Clock::now() + 5s;
+    while (fired.load() < kTimers && Clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(fired.load() == kTimers);
+    assert(!early);
+    wheel.ScheduleAfter(10ms, [&] { late = true; });
+    deadline = Clock::now() + 5s;
+    while (!late && Clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(late);
+    assert(wheel.Pending() == 0);
+    wheel.Stop();
+}
+
+// 没有线程池时回调在驱动线程上执行
+void TestDriverInline() {
+    TimerWheel wheel;
+    std::atomic<std::thread::id> id{};
+    std::atomic<bool> fired{false};
+    wheel.ScheduleAfter(2ms, [&] {
+        id = std::this_thread::get_id();
+        fired = true;
+    });
+    Clock::time_point deadline = Clock::now() + 5s;
+    while (!fired && Clock::now() < deadline) {
+        std::this_thread::sleep_for(1ms);
+    }
+    assert(fired);
+    assert(id.load() != std::this_thread::get_id());
+}
+
+int main() {
+    TestManualAdvance();
+    TestFarTimer();
+    TestNeverDeadline();
+    TestPastDeadline();
+    TestDriverWithPool();
+    TestDriverInline();
+    std::cout << "All TimerWheel tests passed" << std::endl;
+    return 0;
+}
@@ -9,3 +9,94 @@ target("test_string", function()
     set_kind("binary")
     add_files("test_string.cpp")
 end)
+
+target("test_task", function()
+    set_kind("binary")
+    add_files("test_task.cpp")
+end)
+
+target("test_function", function()
+    set_kind("binary")
+    add_files("test_function.cpp")
+end)
+
+target("test_shared_ptr", function()
+    set_kind("binary")
+    add_files("test_shared_ptr.cpp")
+end)
+
+target("test_intrusive_ptr", function()
+    set_kind("binary")
+    add_files("test_intrusive_ptr.cpp")
+end)
+
+target("test_reclamation", function()
+    set_kind("binary")
+    add_files("test_reclamation.cpp")
+    set_policy("build.sanitizer.thread", true)
+end)
+
+target("test_optional", function()
+    set_kind("binary")
+    add_files("test_optional.cpp")
+end)
+
+target("test_arena", function()
+    set_kind("binary")
+    add_files("test_arena.cpp")
+end)
+
+target("test_allocator", function()
+    set_kind("binary")
+    add_files("test_allocator.cpp")
+end)
+
+target("test_flat_hash_map", function()
+    set_kind("binary")
+    add_files("test_flat_hash_map.cpp")
+end)
+
+target("test_concurrent_hash_map", function()
+    set_kind("binary")
+    add_files("test_concurrent_hash_map.cpp")
+end)
+
+target("test_flat_map", function()
+    set_kind("binary")
+    add_files("test_flat_map.cpp")
+end)
+
+target("test_lru_cache", function()
+    set_kind("binary")
+    add_files("test_lru_cache.cpp")
+end)
+
+target("test_priority_queue", function()
+    set_kind("binary")
+    add_files("test_priority_queue.cpp")
+end)
+
+target("test_timer_wheel", function()
+    set_kind("binary")
+    add_files("test_timer_wheel.cpp")
+end)
+
+target("test_bitset", function()
+    set_kind("binary")
+    add_files("test_bitset.cpp")
+end)
+
+target("test_soa_vector", function()
+    set_kind("binary")
+    add_files("test_soa_vector.cpp")
+end)
+
+target("test_thread_pool", function()
+    set_kind("binary")
+    add_files("test_thread_pool.cpp")
+end)
+
+target("test_metrics", function()
+    set_kind("binary")
+    add_files("test_metrics.cpp")
+end)